@@ -1,4 +1,4 @@
-QT       += core gui
+QT       += core gui network
 
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
@@ -9,17 +9,56 @@ CONFIG += c++17
 #DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
 
 SOURCES += \
+    gabatch.cpp \
+    gabench.cpp \
+    gacli.cpp \
+    gacolumns.cpp \
+    gajsonstream.cpp \
+    gamarginal.cpp \
     gaengine.cpp \
+    gametrics.cpp \
+    garecovery.cpp \
+    garobust.cpp \
+    gaserver.cpp \
+    gatrace.cpp \
+    gatune.cpp \
     main.cpp \
-    mainwindow.cpp
+    mainwindow.cpp \
+    paxrouter.cpp
 
 HEADERS += \
+    gabatch.h \
+    gabench.h \
+    gacli.h \
+    gacolumns.h \
+    gajsonstream.h \
+    gamarginal.h \
     gaengine.h \
-    mainwindow.h
+    gametrics.h \
+    garecovery.h \
+    garobust.h \
+    gaserver.h \
+    gatrace.h \
+    gatune.h \
+    mainwindow.h \
+    paxrouter.h
+
+# memória do processo no endpoint de métricas
+win32: LIBS += -lpsapi
 
 FORMS += \
     mainwindow.ui
 
+# gate de desempenho: make perfcheck (compara com perf_baseline.json) e
+# make perfbaseline (regrava o baseline)
+win32: PERF_EXE = $$OUT_PWD/release/$${TARGET}.exe
+else:macx: PERF_EXE = $$OUT_PWD/$${TARGET}.app/Contents/MacOS/$${TARGET}
+else: PERF_EXE = $$OUT_PWD/$${TARGET}
+PERF_ARGS = --jsons $$shell_quote($$PWD/../jsons) --baseline $$shell_quote($$PWD/perf_baseline.json)
+perfcheck.commands = $$shell_quote($$shell_path($$PERF_EXE)) --perf-check $$PERF_ARGS
+perfbaseline.commands = $$shell_quote($$shell_path($$PERF_EXE)) --perf-check --update-baseline $$PERF_ARGS
+QMAKE_EXTRA_TARGETS += perfcheck perfbaseline
+
 # Default rules for deployment.
 qnx: target.path = /tmp/$${TARGET}/bin
 else: unix:!android: target.path = /opt/$${TARGET}/bin
@@ -0,0 +1,360 @@
+// gabatch.cpp
+#include "gabatch.h"
+#include "gacli.h"
+#include "gacolumns.h"
+#include "gaengine.h"
+#include "gamarginal.h"
+#include "gametrics.h"
+#include "garobust.h"
+#include "gatrace.h"
+
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QRunnable>
+#include <QScopedPointer>
+#include <QTextStream>
+#include <QThread>
+#include <QThreadPool>
+
+// Formato do batch.json (caminhos relativos ao próprio arquivo):
+// {
+//   "base_dir": "airnet_inputs",     // airports/routes/passengers/fleet/forbidden
+//   "output_dir": "batch_out",
+//   "population": 60, "generations": 60, "threads": 4, "repair": false,
+//   "adaptive_mutation": false,
+//   "crossover": "one_point",        // ou airport_blocks / time_blocks
+//   "gene_layout": "route",          // ou airport_time (como no meta.json)
+//   "columnar": false,               // grava também ga_results.gacol
+//   "robustness": { "samples": 1000, "spread": 0.2, "seed": 1, "top_k": 3 },
+//                                    // grava robustness.json (garobust.h)
+//   "marginal": false,               // grava marginal_value.json (gamarginal.h)
+//   "robust_objective": { "samples": 32, "spread": 0.2, "quantile": 0.1 },
+//                                    // GA otimiza o quantil (sem quantile: a média)
+//   "variants": [
+//     { "name": "base" },
+//     { "name": "sem_GRU_GIG",
+//       "forbidden_od": [ { "orig_id": 1, "dest_id": 2 } ],
+//       "demand_scale": 1.1,
+//       "od_demand_scale": [ { "orig_id": 3, "dest_id": 4, "scale": 1.5 } ] }
+//   ]
+// }
+// Uma variação só acrescenta proibições: pares proibidos no
+// forbidden_routes.json base não têm genes e não podem ser liberados.
+
+namespace {
+
+struct BatchVariant {
+    QString dirName;
+    ScenarioOverlay overlay;
+};
+
+struct BatchRow {
+    bool ok = false;
+    double score = 0.0;
+    QJsonObject summary;
+    double upperBound = 0.0;
+    double gap = 0.0;
+    double seconds = 0.0;
+    QString error;          // detalhe da falha de gravação, se houver
+};
+
+// nome seguro para diretório: letras, dígitos, '-' e '_'
+QString dirNameFor(const QString &name, int index)
+{
+    QString out;
+    for (const QChar c : name)
+        out += (c.isLetterOrNumber() || c == '-' || c == '_') ? c : QChar('_');
+    return out.isEmpty() ? QString("variant_%1").arg(index) : out;
+}
+
+BatchVariant parseVariant(const QJsonObject &o, int index)
+{
+    BatchVariant v;
+    v.overlay = overlayFromJson(o);
+    v.overlay.name = o.value("name").toString(QString("variant_%1").arg(index));
+    v.dirName = dirNameFor(v.overlay.name, index);
+    return v;
+}
+
+} // namespace
+
+ScenarioOverlay overlayFromJson(const QJsonObject &o)
+{
+    ScenarioOverlay overlay;
+    overlay.name = o.value("name").toString();
+    overlay.demandScale = o.value("demand_scale").toDouble(1.0);
+    for (const QJsonValue &fv : o.value("forbidden_od").toArray()) {
+        QJsonObject fo = fv.toObject();
+        const int orig = fo.value("orig_id").toInt(-1);
+        const int dest = fo.value("dest_id").toInt(-1);
+        if (orig >= 0 && dest >= 0)
+            overlay.forbiddenOD.insert(GAEngine::odKey(orig, dest));
+    }
+    for (const QJsonValue &sv : o.value("od_demand_scale").toArray()) {
+        QJsonObject so = sv.toObject();
+        const int orig = so.value("orig_id").toInt(-1);
+        const int dest = so.value("dest_id").toInt(-1);
+        if (orig >= 0 && dest >= 0)
+            overlay.odDemandScale.insert(GAEngine::odKey(orig, dest),
+                                         so.value("scale").toDouble(1.0));
+    }
+    return overlay;
+}
+
+bool crossoverFromString(const QString &name, GAEngine::CrossoverMode &mode)
+{
+    if (name == "one_point")           mode = GAEngine::CrossoverMode::OnePoint;
+    else if (name == "airport_blocks") mode = GAEngine::CrossoverMode::AirportBlocks;
+    else if (name == "time_blocks")    mode = GAEngine::CrossoverMode::TimeBlocks;
+    else return false;
+    return true;
+}
+
+int runBatch(const QStringList &args)
+{
+    QTextStream out(stdout);
+
+    const QString batchPath = argValue(args, "--batch", QString());
+    QFile bf(batchPath);
+    if (batchPath.isEmpty() || !bf.open(QIODevice::ReadOnly)) {
+        out << "[batch] cannot open batch file: " << batchPath << "\n";
+        return 1;
+    }
+    QJsonParseError pe;
+    QJsonDocument batchDoc = QJsonDocument::fromJson(bf.readAll(), &pe);
+    bf.close();
+    if (pe.error != QJsonParseError::NoError) {
+        out << "[batch] JSON parse error in " << batchPath << ": " << pe.errorString() << "\n";
+        return 1;
+    }
+
+    const QJsonObject cfg = batchDoc.object();
+    const QDir batchDir = QFileInfo(batchPath).absoluteDir();
+    const QDir baseDir(batchDir.absoluteFilePath(cfg.value("base_dir").toString(".")));
+    const QDir outDir(batchDir.absoluteFilePath(cfg.value("output_dir").toString("batch_out")));
+    const int population  = cfg.value("population").toInt(60);
+    const int generations = cfg.value("generations").toInt(60);
+    const bool repair     = cfg.value("repair").toBool(false);
+    const bool adaptive   = cfg.value("adaptive_mutation").toBool(false);
+    GAEngine::CrossoverMode crossoverMode = GAEngine::CrossoverMode::OnePoint;
+    if (!crossoverFromString(cfg.value("crossover").toString("one_point"), crossoverMode)) {
+        out << "[batch] unknown crossover '" << cfg.value("crossover").toString() << "'\n";
+        return 1;
+    }
+    const QString layoutName = cfg.value("gene_layout").toString();
+    if (!layoutName.isEmpty() && layoutName != "route" && layoutName != "airport_time") {
+        out << "[batch] unknown gene_layout '" << layoutName << "'\n";
+        return 1;
+    }
+    const bool columnar   = cfg.value("columnar").toBool(false);
+    const bool marginal   = cfg.value("marginal").toBool(false);
+    const QJsonObject robustCfg = cfg.value("robustness").toObject();
+    const QJsonObject objCfg    = cfg.value("robust_objective").toObject();
+    for (const char *key : { "robustness", "robust_objective" }) {
+        const QJsonObject o = cfg.value(key).toObject();
+        if (o.contains("samples") && o.value("samples").toInt(0) <= 0) {
+            out << "[batch] " << key << ": 'samples' must be a positive integer\n";
+            return 1;
+        }
+    }
+    auto robustOptions = [](const QJsonObject &o, int defSamples) {
+        RobustnessOptions opt;
+        opt.samples = o.value("samples").toInt(defSamples);
+        opt.spread  = o.value("spread").toDouble(0.2);
+        opt.seed    = quint32(o.value("seed").toInt(1));
+        opt.threads = 1; // variações já rodam em paralelo
+        return opt;
+    };
+    int threads = argValue(args, "--threads",
+                           QString::number(cfg.value("threads").toInt(0))).toInt();
+    if (threads <= 0)
+        threads = QThread::idealThreadCount();
+
+    QVector<BatchVariant> variants;
+    const QJsonArray arrVar = cfg.value("variants").toArray();
+    for (int i = 0; i < arrVar.size(); ++i)
+        variants.append(parseVariant(arrVar[i].toObject(), i));
+    if (variants.isEmpty()) {
+        out << "[batch] " << batchPath << ": missing 'variants' array\n";
+        return 1;
+    }
+
+    // timeline opcional (--trace arquivo.json), inclui a carga do cenário
+    const QString tracePath = argValue(args, "--trace", QString());
+    if (!tracePath.isEmpty())
+        GATrace::start();
+
+    // cenário base: carregado uma vez, só leitura para todas as threads
+    QString err;
+    ScenarioPtr base = GAEngine::loadScenario(baseDir.filePath("airports.json"),
+                                              baseDir.filePath("routes.json"),
+                                              baseDir.filePath("passengers.json"),
+                                              baseDir.filePath("fleet.json"),
+                                              baseDir.filePath("forbidden_routes.json"),
+                                              err);
+    if (!base) {
+        out << "[batch] " << err << "\n";
+        return 1;
+    }
+    if (!layoutName.isEmpty())
+        base = GAEngine::withGeneLayout(base, layoutName == "airport_time"
+                                                  ? GeneLayout::AirportTime : GeneLayout::Route);
+    if (!QDir().mkpath(outDir.absolutePath())) {
+        out << "[batch] cannot create output dir " << outDir.absolutePath() << "\n";
+        return 1;
+    }
+
+    out << "[batch] scenario: " << baseDir.absolutePath()
+        << " | genes: " << base->allFlights.size()
+        << " | variants: " << variants.size()
+        << " | threads: " << threads << "\n";
+    out.flush();
+
+    QVector<BatchRow> rows(variants.size());
+    QMutex outMutex;
+
+    // cada tarefa escreve só na sua linha (sem detach concorrente)
+    BatchRow *rowData = rows.data();
+
+    // endpoint de métricas opcional (--metrics-port N)
+    const int metricsPort = argValue(args, "--metrics-port", "0").toInt();
+    QScopedPointer<MetricsServer> metricsServer;
+    if (metricsPort > 0) {
+        metricsServer.reset(new MetricsServer((quint16)metricsPort));
+        if (!metricsServer->startServer(err)) {
+            out << "[batch] " << err << "\n";
+            return 1;
+        }
+        out << "[batch] metrics: http://127.0.0.1:" << metricsPort << "/metrics\n";
+        out.flush();
+    }
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(threads);
+    for (int i = 0; i < variants.size(); ++i) {
+        pool.start(QRunnable::create([&, rowData, i]() {
+            const BatchVariant &v = variants.at(i);
+            QElapsedTimer timer;
+            timer.start();
+
+            GAEngine engine;
+            engine.setScenario(base, v.overlay);
+            engine.setRepairEnabled(repair);
+            engine.setAdaptiveMutation(adaptive);
+            engine.setCrossoverMode(crossoverMode);
+            if (!objCfg.isEmpty())
+                engine.setRobustObjective(sampleDemandSet(engine, robustOptions(objCfg, 32)),
+                                          objCfg.value("quantile").toDouble(-1.0));
+            if (!robustCfg.isEmpty())
+                engine.setKeepTopSchedules(robustCfg.value("top_k").toInt(1));
+            if (metricsServer) {
+                QSharedPointer<GAMetrics> metrics = QSharedPointer<GAMetrics>::create();
+                metricsServer->addRun(v.overlay.name, metrics);
+                engine.setMetrics(metrics);
+            }
+            GAResult res = engine.runGA(population, generations);
+
+            BatchRow &row = rowData[i];
+            row.seconds    = timer.elapsed() / 1000.0;
+            row.score      = res.bestScore;
+            row.summary    = res.fullJson.object().value("summary").toObject();
+            row.upperBound = engine.scoreUpperBound();
+            row.gap        = engine.optimalityGap(res.bestScore);
+
+            {
+                GA_TRACE_SCOPE("writeOutputs", "output", i);
+                QDir vDir(outDir.filePath(v.dirName));
+                row.ok = QDir().mkpath(vDir.absolutePath())
+                         && writeJson(vDir.filePath("flights_ga.json"), res.fullJson)
+                         && writeJson(vDir.filePath("passengers_flights.json"), res.passengersJson)
+                         && writeJson(vDir.filePath("ga_stats.json"), res.evolutionJson);
+                if (row.ok && columnar)
+                    row.ok = writeColumnar(vDir.filePath("ga_results.gacol"),
+                                           resultColumns(res), row.error);
+                if (row.ok && marginal) {
+                    MarginalOptions mopt;
+                    mopt.threads = 1; // variações já rodam em paralelo
+                    row.ok = writeJson(vDir.filePath("marginal_value.json"),
+                                       QJsonDocument(marginalValueReport(engine, res, mopt)));
+                }
+                if (row.ok && !robustCfg.isEmpty()) {
+                    // topFlights[0] é a melhor da população final; sem ela, a melhor do run
+                    QVector<QVector<FlightInstance>> schedules = res.topFlights;
+                    if (schedules.isEmpty())
+                        schedules.append(res.bestFlights);
+                    row.ok = writeJson(vDir.filePath("robustness.json"),
+                                       QJsonDocument(robustnessReport(
+                                           engine, schedules, robustOptions(robustCfg, 1000))));
+                }
+            }
+
+            QMutexLocker lock(&outMutex);
+            out << QString("[batch] %1: score %2 | %3 s%4\n")
+                       .arg(v.overlay.name)
+                       .arg(row.score, 0, 'f', 0)
+                       .arg(row.seconds, 0, 'f', 1)
+                       .arg(row.ok ? QString()
+                                   : row.error.isEmpty() ? QString(" [ERROR writing outputs]")
+                                                         : " [ERROR writing outputs: " + row.error + "]");
+            out.flush();
+        }));
+    }
+    pool.waitForDone();
+
+    if (!tracePath.isEmpty()) {
+        GATrace::stop();
+        if (GATrace::writeJson(tracePath, err))
+            out << "[batch] trace: " << tracePath << " (" << GATrace::eventCount() << " events, "
+                << GATrace::droppedCount() << " dropped)\n";
+        else
+            out << "[batch] " << err << "\n";
+    }
+
+    // tabela comparativa, na ordem do batch.json
+    const QString csvPath = outDir.filePath("batch_summary.csv");
+    QFile csv(csvPath);
+    if (!csv.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        out << "[batch] cannot write " << csvPath << "\n";
+        return 1;
+    }
+    QTextStream cs(&csv);
+    cs << "variant,score,served_total,unserved,num_flights,used_aircraft,"
+          "total_travel_time_min,score_upper_bound,gap,seconds,output_dir\n";
+    out << QString("\n%1 %2 %3 %4 %5 %6 %7\n")
+               .arg("variant", -24).arg("score", 14).arg("served", 8)
+               .arg("unserved", 8).arg("flights", 7).arg("gap%", 7).arg("sec", 7);
+    bool allOk = true;
+    for (int i = 0; i < variants.size(); ++i) {
+        const BatchRow &r = rows[i];
+        const QJsonObject &s = r.summary;
+        allOk = allOk && r.ok;
+        cs << '"' << variants[i].overlay.name << "\","
+           << QString::number(r.score, 'f', 2) << ','
+           << s.value("served_total").toInt() << ','
+           << s.value("unserved").toInt() << ','
+           << s.value("num_flights").toInt() << ','
+           << s.value("used_aircraft").toInt() << ','
+           << QString::number(s.value("total_travel_time_min").toDouble(), 'f', 0) << ','
+           << QString::number(r.upperBound, 'f', 2) << ','
+           << QString::number(r.gap, 'f', 6) << ','
+           << QString::number(r.seconds, 'f', 3) << ','
+           << variants[i].dirName << '\n';
+        out << QString("%1 %2 %3 %4 %5 %6 %7\n")
+                   .arg(variants[i].overlay.name.left(24), -24)
+                   .arg(r.score, 14, 'f', 0)
+                   .arg(s.value("served_total").toInt(), 8)
+                   .arg(s.value("unserved").toInt(), 8)
+                   .arg(s.value("num_flights").toInt(), 7)
+                   .arg(100.0 * r.gap, 7, 'f', 2)
+                   .arg(r.seconds, 7, 'f', 1);
+    }
+    out << "\n[batch] summary: " << csvPath << "\n";
+
+    return allOk ? 0 : 1;
+}
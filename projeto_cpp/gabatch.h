@@ -0,0 +1,25 @@
+// gabatch.h
+#ifndef GABATCH_H
+#define GABATCH_H
+
+#include "gaengine.h"
+
+#include <QJsonObject>
+#include <QStringList>
+
+// Modo headless de lote (estudos what-if):
+//   AeroportosGA --batch <batch.json> [--threads N] [--metrics-port P]
+//            [--trace trace.json]
+// Carrega o cenário base uma vez, roda as variações (pares OD proibidos,
+// multiplicadores de demanda) em paralelo e grava as saídas de cada uma
+// mais uma tabela comparativa (batch_summary.csv).
+int runBatch(const QStringList &args);
+
+// variação de cenário no formato de um item de "variants" (name,
+// forbidden_od, demand_scale, od_demand_scale); também usada pelo --serve
+ScenarioOverlay overlayFromJson(const QJsonObject &o);
+
+// "one_point", "airport_blocks" ou "time_blocks"; false se desconhecido
+bool crossoverFromString(const QString &name, GAEngine::CrossoverMode &mode);
+
+#endif // GABATCH_H
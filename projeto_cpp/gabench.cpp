@@ -0,0 +1,540 @@
+// gabench.cpp
+#include "gabench.h"
+#include "gacli.h"
+#include "gaengine.h"
+#include "gametrics.h"
+
+#include <QDateTime>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QRandomGenerator>
+#include <QSysInfo>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <QThread>
+#include <QtMath>
+
+#include <cmath>
+
+namespace {
+
+// avalia todos os cromossomos e devolve avaliações/segundo
+double timeEvaluations(const GAEngine &engine,
+                       const QVector<QVector<bool>> &chroms,
+                       double &checksum)
+{
+    EvalStats s;
+    QVector<FlightInstance> flightsTmp;
+    QVector<QVariantMap> paxTmp;
+
+    QElapsedTimer timer;
+    timer.start();
+    checksum = 0.0;
+    for (const QVector<bool> &c : chroms)
+        checksum += engine.evaluateChromosome(c, s, flightsTmp, paxTmp);
+    double secs = timer.nsecsElapsed() / 1e9;
+    return (secs > 0.0) ? chroms.size() / secs : 0.0;
+}
+
+QVector<QVector<bool>> randomChromosomes(int genes, int count, double density, quint32 seed)
+{
+    QRandomGenerator rng(seed);
+    QVector<QVector<bool>> chroms;
+    chroms.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        QVector<bool> c(genes);
+        for (int g = 0; g < c.size(); ++g)
+            c[g] = (rng.generateDouble() < density);
+        chroms.append(c);
+    }
+    return chroms;
+}
+
+// ---------------------------------------------------------------------------
+// gate de regressão de desempenho (--perf-check)
+
+constexpr int PerfBaselineVersion = 1;
+
+// cenários fixos: os JSONs do repositório e malhas sintéticas maiores
+// (scale x 14 aeroportos), geradas sempre com a mesma semente
+struct PerfScenario {
+    const char *name;
+    int scale;   // 0 = pasta --jsons
+};
+const PerfScenario PerfScenarios[] = {
+    { "jsons",        0 },
+    { "synthetic_x2", 2 },
+    { "synthetic_x3", 3 },
+};
+
+struct PerfMetric {
+    const char *key;
+    bool higherIsBetter;
+    double tolerance;   // padrão; o baseline pode sobrescrever
+};
+const PerfMetric PerfMetrics[] = {
+    { "evals_per_sec",      true,  0.10 },
+    { "ga_seconds",         false, 0.15 },
+    { "time_to_target_sec", false, 0.20 },
+    { "peak_rss_mb",        false, 0.15 },
+};
+
+// fração da execução de referência cujo melhor score vira o alvo
+constexpr double TargetFraction = 0.75;
+
+struct PerfConfig {
+    int population  = 60;
+    int generations = 80;
+    int samples     = 200;
+    quint32 seed    = 12345;
+    int repeats     = 3;
+};
+
+bool writeJsonFile(const QString &path, const QJsonObject &root, QString &error)
+{
+    if (writeJson(path, QJsonDocument(root)))
+        return true;
+    error = "cannot write " + path;
+    return false;
+}
+
+// cenário sintético no formato dos JSONs de entrada: aeroportos sorteados
+// no território, todas as rotas (tempo pela distância), demanda em ~60%
+// dos pares e frota proporcional ao número de aeroportos
+bool writeSyntheticScenario(const QString &dir, int numAirports, quint32 seed, QString &error)
+{
+    QRandomGenerator rng(seed);
+    QVector<double> lat(numAirports), lon(numAirports);
+    QJsonArray airports;
+    for (int i = 0; i < numAirports; ++i) {
+        lat[i] = -30.0 + 30.0 * rng.generateDouble();
+        lon[i] = -70.0 + 35.0 * rng.generateDouble();
+        QJsonObject o;
+        o["id"]   = i;
+        o["code"] = QString("S%1").arg(i, 2, 10, QChar('0'));
+        o["name"] = QString("Synthetic %1").arg(i);
+        o["lat"]  = lat[i];
+        o["lon"]  = lon[i];
+        airports.append(o);
+    }
+
+    QJsonArray routes, od;
+    for (int a = 0; a < numAirports; ++a) {
+        for (int b = 0; b < numAirports; ++b) {
+            if (a == b)
+                continue;
+            // ~111 km por grau, 800 km/h, +30 min de solo; múltiplo de 30
+            const double km = 111.0 * std::hypot(lat[a] - lat[b],
+                                                 (lon[a] - lon[b]) * std::cos(qDegreesToRadians(lat[a])));
+            const int minutes = qMax(60, int(std::ceil((km / 800.0 * 60.0 + 30.0) / 30.0)) * 30);
+            QJsonObject r;
+            r["id"]       = routes.size();
+            r["orig_id"]  = a;
+            r["dest_id"]  = b;
+            r["time_min"] = minutes;
+            routes.append(r);
+
+            if (rng.generateDouble() < 0.6) {
+                QJsonObject d;
+                d["id"]      = od.size();
+                d["orig_id"] = a;
+                d["dest_id"] = b;
+                d["demand"]  = 50 + 10 * int(rng.bounded(36));
+                od.append(d);
+            }
+        }
+    }
+
+    QJsonObject fleet;
+    fleet["num_aircraft"]       = 250 * numAirports / 14;
+    fleet["seats_per_aircraft"] = 200;
+
+    QJsonObject ao, ro, po, fo;
+    ao["airports"]     = airports;
+    ro["routes"]       = routes;
+    po["od_pairs"]     = od;
+    fo["forbidden_od"] = QJsonArray();
+    const QDir d(dir);
+    return writeJsonFile(d.filePath("airports.json"), ao, error)
+           && writeJsonFile(d.filePath("routes.json"), ro, error)
+           && writeJsonFile(d.filePath("passengers.json"), po, error)
+           && writeJsonFile(d.filePath("fleet.json"), fleet, error)
+           && writeJsonFile(d.filePath("forbidden_routes.json"), fo, error);
+}
+
+ScenarioPtr loadDir(const QDir &dir, QString &error)
+{
+    return GAEngine::loadScenario(dir.filePath("airports.json"),
+                                  dir.filePath("routes.json"),
+                                  dir.filePath("passengers.json"),
+                                  dir.filePath("fleet.json"),
+                                  dir.filePath("forbidden_routes.json"),
+                                  error);
+}
+
+// mede um cenário; o alvo de score vem do baseline (ou é fixado aqui,
+// na gravação de um baseline novo)
+QJsonObject measureScenario(const ScenarioPtr &data, const PerfConfig &cfg,
+                            const QJsonObject &base, QTextStream &out)
+{
+    GAEngine engine;
+    engine.setScenario(data);
+    QJsonObject m;
+    m["airports"] = data->airports.size();
+    m["genes"]    = data->allFlights.size();
+
+    // 1) vazão do kernel de avaliação (melhor de N repetições)
+    const QVector<QVector<bool>> chroms =
+        randomChromosomes(engine.numGenes(), cfg.samples, 0.05, cfg.seed);
+    double evalsPerSec = 0.0, checksum = 0.0;
+    for (int r = 0; r < cfg.repeats; ++r)
+        evalsPerSec = qMax(evalsPerSec, timeEvaluations(engine, chroms, checksum));
+    m["evals_per_sec"] = evalsPerSec;
+
+    // 2) GA completo com semente fixa: tempo total e tempo até o alvo
+    double target = base.value("target_score").toDouble(qQNaN());
+    double gaSecs = -1.0, timeToTarget = -1.0, bestScore = 0.0;
+    for (int r = 0; r < cfg.repeats; ++r) {
+        QVector<double> at, best;
+        engine.setSeed(cfg.seed);
+        QElapsedTimer timer;
+        timer.start();
+        const GAResult res = engine.runGA(cfg.population, cfg.generations,
+                                          [&](int, double b) {
+            at.append(timer.nsecsElapsed() / 1e9);
+            best.append(b);
+        });
+        const double secs = timer.nsecsElapsed() / 1e9;
+        bestScore = res.bestScore;
+        if (best.isEmpty())
+            continue;
+        if (std::isnan(target))
+            target = best[int(TargetFraction * (best.size() - 1))];
+        double reached = -1.0;
+        for (int i = 0; i < best.size(); ++i) {
+            if (best[i] >= target) {
+                reached = at[i];
+                break;
+            }
+        }
+        gaSecs = gaSecs < 0.0 ? secs : qMin(gaSecs, secs);
+        if (reached >= 0.0)
+            timeToTarget = timeToTarget < 0.0 ? reached : qMin(timeToTarget, reached);
+    }
+    m["ga_seconds"]         = gaSecs;
+    m["target_score"]       = target;
+    m["time_to_target_sec"] = timeToTarget;   // -1 = alvo não alcançado
+    m["best_score"]         = bestScore;
+
+    // pico do processo até aqui (os cenários rodam sempre na mesma ordem)
+    m["peak_rss_mb"] = peakResidentMemoryBytes() / (1024.0 * 1024.0);
+
+    out << QString("[perf] %1 airports, %2 genes | %3 evals/s | GA %4 s | target %5 in %6 s | peak RSS %7 MB\n")
+               .arg(m["airports"].toInt()).arg(m["genes"].toInt())
+               .arg(evalsPerSec, 0, 'f', 1).arg(gaSecs, 0, 'f', 3)
+               .arg(target, 0, 'f', 1).arg(timeToTarget, 0, 'f', 3)
+               .arg(m["peak_rss_mb"].toDouble(), 0, 'f', 1);
+    out.flush();
+    return m;
+}
+
+} // namespace
+
+int runBenchmark(const QStringList &args)
+{
+    QTextStream out(stdout);
+
+    QDir dir(argValue(args, "--bench", "."));
+    const int samples  = argValue(args, "--samples", "200").toInt();
+    const quint32 seed = argValue(args, "--seed", "12345").toUInt();
+
+    GAEngine engine;
+    QString err;
+    if (!engine.loadData(dir.filePath("airports.json"),
+                         dir.filePath("routes.json"),
+                         dir.filePath("passengers.json"),
+                         dir.filePath("fleet.json"),
+                         dir.filePath("forbidden_routes.json"),
+                         err)) {
+        out << "[bench] " << err << "\n";
+        return 1;
+    }
+
+    out << "[bench] scenario: " << dir.absolutePath() << "\n";
+    out << "[bench] airports: " << engine.numAirports()
+        << " | genes: " << engine.numGenes()
+        << " | samples: " << samples << "\n";
+    for (const InputFileStats &st : engine.scenario()->inputStats)
+        out << QString("[bench] input %1: %2 KB parsed in %3 ms\n")
+                   .arg(st.file, -22)
+                   .arg(st.bytes / 1024.0, 0, 'f', 1)
+                   .arg(st.parseMs, 0, 'f', 1);
+
+    // mesmas densidades da população inicial e de indivíduos já evoluídos
+    const double densities[] = { 0.02, 0.10 };
+    for (double density : densities) {
+        const QVector<QVector<bool>> chroms =
+            randomChromosomes(engine.numGenes(), samples, density, seed);
+
+        double sumGeneric = 0.0, sumFixed = 0.0;
+        engine.setFixedKernelEnabled(false);
+        double evGeneric = timeEvaluations(engine, chroms, sumGeneric);
+
+        out << QString("[bench] density %1 | generic: %2 evals/s")
+                   .arg(density, 0, 'f', 2)
+                   .arg(evGeneric, 0, 'f', 1);
+
+        if (engine.fixedKernelAvailable()) {
+            engine.setFixedKernelEnabled(true);
+            double evFixed = timeEvaluations(engine, chroms, sumFixed);
+            out << QString(" | fixed<%1>: %2 evals/s | speedup x%3%4")
+                       .arg(GAConst::MaxFixedAirports)
+                       .arg(evFixed, 0, 'f', 1)
+                       .arg(evGeneric > 0.0 ? evFixed / evGeneric : 0.0, 0, 'f', 2)
+                       .arg(sumFixed == sumGeneric ? QString() : QString(" [SCORE MISMATCH]"));
+        } else {
+            out << " | fixed kernel unavailable";
+        }
+        out << "\n";
+    }
+
+    // tempo até o alvo: ordem por rota + corte de um ponto (referência)
+    // contra a ordem por aeroporto/horário com os crossovers por blocos.
+    // Alvo de cada semente = melhor score final da referência
+    const int gaPop   = argValue(args, "--ga-population", "60").toInt();
+    const int gaGens  = argValue(args, "--ga-generations", "100").toInt();
+    const int gaSeeds = argValue(args, "--ga-seeds", "3").toInt();
+    if (gaGens <= 0 || gaSeeds <= 0)
+        return 0;
+
+    struct LayoutRun {
+        const char *name;
+        GeneLayout layout;
+        GAEngine::CrossoverMode mode;
+    };
+    const LayoutRun runs[] = {
+        { "route / one-point",             GeneLayout::Route,       GAEngine::CrossoverMode::OnePoint },
+        { "airport-time / one-point",      GeneLayout::AirportTime, GAEngine::CrossoverMode::OnePoint },
+        { "airport-time / airport blocks", GeneLayout::AirportTime, GAEngine::CrossoverMode::AirportBlocks },
+        { "airport-time / time blocks",    GeneLayout::AirportTime, GAEngine::CrossoverMode::TimeBlocks },
+    };
+    out << QString("[bench] time to target | population %1 | generations %2 | seeds %3\n")
+               .arg(gaPop).arg(gaGens).arg(gaSeeds);
+
+    QVector<double> targets(gaSeeds, 0.0);
+    double refSecs = 0.0;
+    for (const LayoutRun &run : runs) {
+        GAEngine ga;
+        ga.setScenario(GAEngine::withGeneLayout(engine.scenario(), run.layout));
+        ga.setCrossoverMode(run.mode);
+        const bool reference = (&run == &runs[0]);
+        double sumSecs = 0.0, sumGens = 0.0, sumBest = 0.0;
+        int reached = 0;
+        for (int k = 0; k < gaSeeds; ++k) {
+            ga.setSeed(seed + k);
+            QElapsedTimer timer;
+            timer.start();
+            double hitSecs = -1.0;
+            int hitGen = -1;
+            const GAResult res = ga.runGA(gaPop, gaGens, [&](int gen, double best) {
+                if (hitGen < 0 && !reference && best >= targets[k]) {
+                    hitSecs = timer.nsecsElapsed() / 1e9;
+                    hitGen  = gen;
+                }
+            });
+            if (reference) {
+                targets[k] = res.bestScore;
+                hitSecs    = timer.nsecsElapsed() / 1e9;
+                hitGen     = gaGens;
+            }
+            sumBest += res.bestScore;
+            if (hitGen >= 0) {
+                ++reached;
+                sumSecs += hitSecs;
+                sumGens += hitGen;
+            }
+        }
+        const double meanSecs = reached > 0 ? sumSecs / reached : 0.0;
+        if (reference)
+            refSecs = meanSecs;
+        out << QString("[bench]   %1 | best %2 | target reached %3/%4")
+                   .arg(run.name, -30)
+                   .arg(sumBest / gaSeeds, 0, 'f', 1)
+                   .arg(reached).arg(gaSeeds);
+        if (reached > 0) {
+            out << QString(" | %1 s, gen %2").arg(meanSecs, 0, 'f', 3).arg(sumGens / reached, 0, 'f', 1);
+            if (!reference && meanSecs > 0.0)
+                out << QString(" | x%1 vs reference").arg(refSecs / meanSecs, 0, 'f', 2);
+        }
+        out << "\n";
+        out.flush();
+    }
+
+    return 0;
+}
+
+int runPerfCheck(const QStringList &args)
+{
+    QTextStream out(stdout);
+    const QString baselinePath = argValue(args, "--baseline", "perf_baseline.json");
+    const QDir jsonsDir(argValue(args, "--jsons", "../jsons"));
+    const bool update = args.contains("--update-baseline");
+
+    // baseline existente: configuração, tolerâncias e alvos de score
+    QJsonObject baseline;
+    {
+        QFile f(baselinePath);
+        if (f.open(QIODevice::ReadOnly)) {
+            QJsonParseError pe;
+            const QJsonDocument doc = QJsonDocument::fromJson(f.readAll(), &pe);
+            if (pe.error != QJsonParseError::NoError || !doc.isObject()) {
+                out << "[perf] " << baselinePath << ": " << pe.errorString() << "\n";
+                return 1;
+            }
+            baseline = doc.object();
+        } else if (!update) {
+            out << "[perf] no baseline at " << baselinePath
+                << " (record one with --perf-check --update-baseline)\n";
+            return 1;
+        }
+    }
+    if (!baseline.isEmpty() && baseline.value("version").toInt() != PerfBaselineVersion) {
+        out << "[perf] " << baselinePath << ": unsupported baseline version "
+            << baseline.value("version").toInt() << "\n";
+        return 1;
+    }
+
+    // na checagem, a configuração é sempre a do baseline
+    const QJsonObject baseCfg = baseline.value("config").toObject();
+    PerfConfig cfg;
+    auto pick = [&](const char *key, const QString &flag, double def) {
+        if (update && args.contains(flag))
+            return argValue(args, flag, QString()).toDouble();
+        return baseCfg.value(key).toDouble(def);
+    };
+    cfg.population  = int(pick("population",  "--population",  cfg.population));
+    cfg.generations = int(pick("generations", "--generations", cfg.generations));
+    cfg.samples     = int(pick("samples",     "--samples",     cfg.samples));
+    cfg.seed        = quint32(pick("seed",    "--seed",        cfg.seed));
+    cfg.repeats     = qMax(1, int(pick("repeats", "--repeats", cfg.repeats)));
+
+    QJsonObject tolerances = baseline.value("tolerances").toObject();
+    for (const PerfMetric &pm : PerfMetrics)
+        if (!tolerances.contains(pm.key))
+            tolerances[pm.key] = pm.tolerance;
+    for (int i = 0; i + 1 < args.size(); ++i) {   // --tolerance metric=frac (pode repetir)
+        if (args[i] != "--tolerance")
+            continue;
+        const QStringList kv = args[i + 1].split('=');
+        if (kv.size() == 2 && tolerances.contains(kv[0]))
+            tolerances[kv[0]] = kv[1].toDouble();
+        else
+            out << "[perf] ignoring --tolerance " << args[i + 1] << "\n";
+    }
+
+    const int threads = QThread::idealThreadCount();
+    const QJsonObject baseScenarios = baseline.value("scenarios").toObject();
+    if (!update && baseline.value("host").toObject().value("threads").toInt() != threads)
+        out << "[perf] warning: baseline recorded with "
+            << baseline.value("host").toObject().value("threads").toInt()
+            << " threads, this host has " << threads << "\n";
+
+    QJsonObject current;
+    for (const PerfScenario &ps : PerfScenarios) {
+        QString err;
+        ScenarioPtr data;
+        QTemporaryDir tmp;
+        if (ps.scale == 0) {
+            data = loadDir(jsonsDir, err);
+        } else if (!tmp.isValid()) {
+            err = "cannot create a temporary directory";
+        } else if (writeSyntheticScenario(tmp.path(), 14 * ps.scale, cfg.seed + ps.scale, err)) {
+            data = loadDir(QDir(tmp.path()), err);
+        }
+        if (!data) {
+            out << "[perf] " << ps.name << ": " << err << "\n";
+            return 1;
+        }
+        out << "[perf] " << ps.name << "\n";
+        current[ps.name] = measureScenario(data, cfg, baseScenarios.value(ps.name).toObject(), out);
+    }
+
+    if (update) {
+        QJsonObject cfgObj, host, root;
+        cfgObj["population"]  = cfg.population;
+        cfgObj["generations"] = cfg.generations;
+        cfgObj["samples"]     = cfg.samples;
+        cfgObj["seed"]        = (double)cfg.seed;
+        cfgObj["repeats"]     = cfg.repeats;
+        host["threads"]       = threads;
+        host["os"]            = QSysInfo::prettyProductName();
+        root["version"]       = PerfBaselineVersion;
+        root["recorded"]      = QDateTime::currentDateTime().toString(Qt::ISODate);
+        root["host"]          = host;
+        root["config"]        = cfgObj;
+        root["tolerances"]    = tolerances;
+        root["scenarios"]     = current;
+        QString err;
+        if (!writeJsonFile(baselinePath, root, err)) {
+            out << "[perf] " << err << "\n";
+            return 1;
+        }
+        out << "[perf] baseline written to " << baselinePath << "\n";
+        return 0;
+    }
+
+    // relatório: uma linha por (cenário, métrica)
+    int regressions = 0;
+    out << "\n" << QString("%1 %2 %3 %4 %5  %6\n")
+                      .arg("scenario", -14).arg("metric", -20).arg("baseline", 12)
+                      .arg("current", 12).arg("change", 8).arg("status");
+    for (const PerfScenario &ps : PerfScenarios) {
+        const QJsonObject b = baseScenarios.value(ps.name).toObject();
+        const QJsonObject c = current.value(ps.name).toObject();
+        if (b.isEmpty()) {
+            out << QString("%1 (not in baseline)\n").arg(ps.name, -14);
+            continue;
+        }
+        for (const PerfMetric &pm : PerfMetrics) {
+            const double bv  = b.value(pm.key).toDouble();
+            const double cv  = c.value(pm.key).toDouble();
+            const double tol = tolerances.value(pm.key).toDouble();
+            QString status = "ok";
+            double change = 0.0;
+            if (cv < 0.0) {
+                status = "REGRESSION (target not reached)";
+            } else if (bv > 0.0) {
+                change = (cv - bv) / bv;
+                const double worse = pm.higherIsBetter ? -change : change;
+                if (worse > tol)
+                    status = QString("REGRESSION (> %1%)").arg(tol * 100.0, 0, 'f', 0);
+                else if (-worse > tol)
+                    status = "improved";
+            }
+            if (status.startsWith("REGRESSION"))
+                ++regressions;
+            out << QString("%1 %2 %3 %4 %5  %6\n")
+                       .arg(ps.name, -14).arg(pm.key, -20)
+                       .arg(bv, 12, 'f', 3).arg(cv, 12, 'f', 3)
+                       .arg(QString("%1%2%").arg(change >= 0.0 ? "+" : "").arg(change * 100.0, 0, 'f', 1), 8)
+                       .arg(status);
+        }
+        // mesma semente e configuração: o score final só muda se o algoritmo mudou
+        if (b.value("best_score").toDouble() != c.value("best_score").toDouble())
+            out << QString("%1 note: best score %2 -> %3 (search behaviour changed)\n")
+                       .arg(ps.name, -14)
+                       .arg(b.value("best_score").toDouble(), 0, 'f', 1)
+                       .arg(c.value("best_score").toDouble(), 0, 'f', 1);
+    }
+
+    if (regressions > 0) {
+        out << "\n[perf] FAILED: " << regressions << " metric(s) regressed beyond tolerance\n";
+        return 2;
+    }
+    out << "\n[perf] OK: no regressions\n";
+    return 0;
+}
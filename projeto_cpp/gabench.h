@@ -0,0 +1,27 @@
+// gabench.h
+#ifndef GABENCH_H
+#define GABENCH_H
+
+#include <QStringList>
+
+// Modo headless de benchmark:
+//   AeroportosGA --bench <dir-com-jsons> [--samples N] [--seed S]
+//            [--ga-population P] [--ga-generations G] [--ga-seeds K]
+// Mede avaliações/segundo dos kernels de avaliação do GAEngine e o tempo
+// até o score alvo da ordem de genes por aeroporto/horário com crossover
+// por blocos, contra a ordem por rota com corte de um ponto
+// (--ga-generations 0 pula essa parte).
+int runBenchmark(const QStringList &args);
+
+// Gate de regressão de desempenho:
+//   AeroportosGA --perf-check [--baseline perf_baseline.json] [--jsons ../jsons]
+//            [--tolerance metric=frac]... [--repeats N]
+//   AeroportosGA --perf-check --update-baseline [--population P]
+//            [--generations G] [--samples N] [--seed S]
+// Roda um conjunto fixo de cenários com semente (jsons/ e sintéticos 2x e
+// 3x maiores), mede avaliações/s, tempo do GA, tempo até o score alvo e
+// pico de memória, e compara com o baseline versionado. Retorna 2 quando
+// alguma métrica piora além da tolerância.
+int runPerfCheck(const QStringList &args);
+
+#endif // GABENCH_H
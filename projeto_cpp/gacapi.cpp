@@ -0,0 +1,257 @@
+// gacapi.cpp
+#include "gacapi.h"
+#include "gacolumns.h"
+#include "gaengine.h"
+
+#include <QByteArray>
+#include <QString>
+
+struct ga_engine {
+    GAEngine engine;
+    bool loaded = false;
+    QByteArray lastError;
+
+    // buffers reaproveitados entre chamadas de ga_evaluate
+    QVector<bool> chrom;
+    EvalStats stats;
+    QVector<FlightInstance> flights;
+    QVector<QVariantMap> pax;
+};
+
+struct ga_result {
+    double score = 0.0;
+    QByteArray summary;
+    ResultColumns cols;
+};
+
+namespace {
+
+// limpa o erro da chamada anterior e confere se há cenário
+bool requireData(ga_engine *e)
+{
+    e->lastError.clear();
+    if (e->loaded)
+        return true;
+    e->lastError = "no scenario loaded (call ga_load_data first)";
+    return false;
+}
+
+void statsToArray(const EvalStats &s, double *out)
+{
+    out[0] = s.servedTotal;
+    out[1] = s.servedDirect;
+    out[2] = s.servedOneHop;
+    out[3] = s.servedMultiHop;
+    out[4] = s.unserved;
+    out[5] = s.numFlights;
+    out[6] = s.usedAircraft;
+    out[7] = (double)s.totalTravelTime;
+}
+
+// copia genes 0/1 para o cromossomo denso reaproveitado
+bool loadChromosome(ga_engine *e, const unsigned char *genes, int numGenes)
+{
+    if (numGenes != e->engine.numGenes()) {
+        e->lastError = QString("chromosome has %1 genes, scenario has %2")
+                           .arg(numGenes).arg(e->engine.numGenes()).toUtf8();
+        return false;
+    }
+    e->chrom.resize(numGenes);
+    bool *c = e->chrom.data();
+    for (int i = 0; i < numGenes; ++i)
+        c[i] = genes[i] != 0;
+    return true;
+}
+
+} // namespace
+
+ga_engine *ga_engine_new(void)
+{
+    return new ga_engine;
+}
+
+void ga_engine_free(ga_engine *e)
+{
+    delete e;
+}
+
+const char *ga_last_error(const ga_engine *e)
+{
+    return e->lastError.constData();
+}
+
+int ga_load_data(ga_engine *e, const char *airports, const char *routes,
+                 const char *passengers, const char *fleet, const char *forbidden)
+{
+    QString err;
+    e->lastError.clear();
+    e->loaded = e->engine.loadData(QString::fromUtf8(airports), QString::fromUtf8(routes),
+                                   QString::fromUtf8(passengers), QString::fromUtf8(fleet),
+                                   QString::fromUtf8(forbidden), err);
+    if (!e->loaded) {
+        e->lastError = err.toUtf8();
+        return -1;
+    }
+    return 0;
+}
+
+int ga_num_genes(const ga_engine *e)
+{
+    return e->loaded ? e->engine.numGenes() : 0;
+}
+
+int ga_num_airports(const ga_engine *e)
+{
+    return e->loaded ? e->engine.numAirports() : 0;
+}
+
+double ga_score_upper_bound(const ga_engine *e)
+{
+    return e->loaded ? e->engine.scoreUpperBound() : 0.0;
+}
+
+void ga_set_params(ga_engine *e, double p_cross, double p_mut,
+                   double elite_frac, int tournament_size)
+{
+    GAParams p;
+    p.pCross         = p_cross;
+    p.pMut           = p_mut;
+    p.eliteFrac      = elite_frac;
+    p.tournamentSize = tournament_size;
+    e->engine.setGAParams(p);
+}
+
+void ga_set_seed(ga_engine *e, unsigned int seed)
+{
+    e->engine.setSeed(seed);
+}
+
+void ga_set_repair(ga_engine *e, int on)
+{
+    e->engine.setRepairEnabled(on != 0);
+}
+
+void ga_set_gap_stop(ga_engine *e, double gap)
+{
+    e->engine.setGapStopThreshold(gap);
+}
+
+void ga_set_adaptive_mutation(ga_engine *e, int on)
+{
+    e->engine.setAdaptiveMutation(on != 0);
+}
+
+ga_result *ga_run(ga_engine *e, int population, int generations,
+                  ga_progress_fn progress, void *user)
+{
+    if (!requireData(e))
+        return nullptr;
+    GAEngine::ProgressCallback cb;
+    if (progress)
+        cb = [progress, user](int gen, double best) { progress(gen, best, user); };
+
+    GAResult res = e->engine.runGA(population, generations, cb);
+
+    ga_result *r = new ga_result;
+    r->score   = res.bestScore;
+    r->summary = res.summaryText.toUtf8();
+    r->cols    = resultColumns(res);
+    return r;
+}
+
+double ga_evaluate(ga_engine *e, const unsigned char *genes, int num_genes,
+                   double *stats_out)
+{
+    if (!requireData(e) || !loadChromosome(e, genes, num_genes))
+        return -1e9;
+    const double score = e->engine.evaluateChromosome(e->chrom, e->stats, e->flights, e->pax);
+    if (stats_out)
+        statsToArray(e->stats, stats_out);
+    return score;
+}
+
+int ga_evaluate_many(ga_engine *e, const unsigned char *genes, int count, int num_genes,
+                     double *scores_out, double *stats_out)
+{
+    if (!requireData(e))
+        return -1;
+    for (int k = 0; k < count; ++k) {
+        if (!loadChromosome(e, genes + (qint64)k * num_genes, num_genes))
+            return -1;
+        scores_out[k] = e->engine.evaluateChromosome(e->chrom, e->stats, e->flights, e->pax);
+        if (stats_out)
+            statsToArray(e->stats, stats_out + (qint64)k * GA_NUM_STATS);
+    }
+    return 0;
+}
+
+ga_result *ga_evaluate_detail(ga_engine *e, const unsigned char *genes, int num_genes)
+{
+    if (!requireData(e) || !loadChromosome(e, genes, num_genes))
+        return nullptr;
+    GAResult res;
+    res.bestScore = e->engine.evaluateChromosome(e->chrom, res.bestStats,
+                                                 res.bestFlights, res.bestPaxAssignments);
+
+    ga_result *r = new ga_result;
+    r->score   = res.bestScore;
+    r->summary = QString("Score: %1 | served %2 | unserved %3 | flights %4\n")
+                     .arg(res.bestScore, 0, 'f', 2)
+                     .arg(res.bestStats.servedTotal)
+                     .arg(res.bestStats.unserved)
+                     .arg(res.bestStats.numFlights).toUtf8();
+    r->cols    = resultColumns(res);
+    return r;
+}
+
+void ga_result_free(ga_result *r)
+{
+    delete r;
+}
+
+double ga_result_score(const ga_result *r)
+{
+    return r->score;
+}
+
+const char *ga_result_summary(const ga_result *r)
+{
+    return r->summary.constData();
+}
+
+int ga_result_num_columns(const ga_result *r)
+{
+    return r->cols.columns.size();
+}
+
+int ga_result_column_info(const ga_result *r, int i, const char **table, const char **name,
+                          int *type, long long *length)
+{
+    if (i < 0 || i >= r->cols.columns.size())
+        return -1;
+    const ResultColumn &c = r->cols.columns.at(i);
+    if (table)  *table  = c.table.constData();
+    if (name)   *name   = c.name.constData();
+    if (type)   *type   = c.isFloat ? GA_FLOAT64 : GA_INT32;
+    if (length) *length = c.size();
+    return 0;
+}
+
+int ga_result_column(const ga_result *r, const char *table, const char *name,
+                     const void **data, int *type, long long *length)
+{
+    const int i = r->cols.indexOf(QByteArray(table), QByteArray(name));
+    if (i < 0)
+        return -1;
+    const ResultColumn &c = r->cols.columns.at(i);
+    if (data)   *data   = c.data();
+    if (type)   *type   = c.isFloat ? GA_FLOAT64 : GA_INT32;
+    if (length) *length = c.size();
+    return 0;
+}
+
+int ga_result_write_columnar(const ga_result *r, const char *path)
+{
+    QString err;
+    return writeColumnar(QString::fromUtf8(path), r->cols, err) ? 0 : -1;
+}
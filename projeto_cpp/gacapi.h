@@ -0,0 +1,112 @@
+/* gacapi.h */
+#ifndef GACAPI_H
+#define GACAPI_H
+
+/*
+ * API C do engine para bindings (python/aeroportos_ga.py via ctypes).
+ * Só tipos C: pode ser lida por ctypes, cffi ou qualquer FFI.
+ *
+ * Ciclo típico:
+ *   ga_engine *e = ga_engine_new();
+ *   ga_load_data(e, "airports.json", ..., "forbidden_routes.json");
+ *   ga_result *r = ga_run(e, 60, 60, progress, user);
+ *   ga_result_column(r, "flights", "dep_min", &data, &type, &len);
+ *   ga_result_free(r);
+ *   ga_engine_free(e);
+ *
+ * As colunas (ver gacolumns.h) pertencem ao ga_result e continuam válidas
+ * até ga_result_free, inclusive depois de novas execuções do engine.
+ * Um engine não pode ser usado por duas threads ao mesmo tempo; engines
+ * diferentes podem.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(_WIN32)
+#  if defined(GACAPI_LIBRARY)
+#    define GACAPI_EXPORT __declspec(dllexport)
+#  else
+#    define GACAPI_EXPORT __declspec(dllimport)
+#  endif
+#else
+#  define GACAPI_EXPORT __attribute__((visibility("default")))
+#endif
+
+typedef struct ga_engine ga_engine;
+typedef struct ga_result ga_result;
+
+/* tipos de coluna */
+#define GA_INT32   1
+#define GA_FLOAT64 2
+
+/* campos de EvalStats em ga_evaluate (stats_out[GA_NUM_STATS]) */
+#define GA_NUM_STATS 8
+/* served_total, served_direct, served_1hop, served_multihop, unserved,
+   num_flights, used_aircraft, total_travel_time_min */
+
+/* chamado a cada geração; retorno ignorado */
+typedef void (*ga_progress_fn)(int generation, double best_score, void *user);
+
+GACAPI_EXPORT ga_engine *ga_engine_new(void);
+GACAPI_EXPORT void ga_engine_free(ga_engine *e);
+
+/* mensagem do último erro deste engine (UTF-8; "" se nenhum) */
+GACAPI_EXPORT const char *ga_last_error(const ga_engine *e);
+
+/* caminhos UTF-8; 0 = ok */
+GACAPI_EXPORT int ga_load_data(ga_engine *e,
+                               const char *airports, const char *routes,
+                               const char *passengers, const char *fleet,
+                               const char *forbidden);
+
+GACAPI_EXPORT int ga_num_genes(const ga_engine *e);
+GACAPI_EXPORT int ga_num_airports(const ga_engine *e);
+GACAPI_EXPORT double ga_score_upper_bound(const ga_engine *e);
+
+/* parâmetros de GAParams, semente e opções de runGA */
+GACAPI_EXPORT void ga_set_params(ga_engine *e, double p_cross, double p_mut,
+                                 double elite_frac, int tournament_size);
+GACAPI_EXPORT void ga_set_seed(ga_engine *e, unsigned int seed);
+GACAPI_EXPORT void ga_set_repair(ga_engine *e, int on);
+GACAPI_EXPORT void ga_set_gap_stop(ga_engine *e, double gap);
+GACAPI_EXPORT void ga_set_adaptive_mutation(ga_engine *e, int on);
+
+/* roda o GA; NULL se não houver dados carregados */
+GACAPI_EXPORT ga_result *ga_run(ga_engine *e, int population, int generations,
+                                ga_progress_fn progress, void *user);
+
+/* avalia um cromossomo denso (genes[num_genes], 0/1); stats_out pode ser NULL */
+GACAPI_EXPORT double ga_evaluate(ga_engine *e, const unsigned char *genes, int num_genes,
+                                 double *stats_out);
+/* count cromossomos consecutivos em genes[count * num_genes];
+   scores_out[count], stats_out[count * GA_NUM_STATS] (pode ser NULL) */
+GACAPI_EXPORT int ga_evaluate_many(ga_engine *e, const unsigned char *genes,
+                                   int count, int num_genes,
+                                   double *scores_out, double *stats_out);
+/* avaliação com a solução completa (voos e passageiros) em colunas */
+GACAPI_EXPORT ga_result *ga_evaluate_detail(ga_engine *e, const unsigned char *genes,
+                                            int num_genes);
+
+GACAPI_EXPORT void ga_result_free(ga_result *r);
+GACAPI_EXPORT double ga_result_score(const ga_result *r);
+/* resumo em texto (o mesmo do GUI), UTF-8 */
+GACAPI_EXPORT const char *ga_result_summary(const ga_result *r);
+GACAPI_EXPORT int ga_result_num_columns(const ga_result *r);
+/* nome da tabela e da coluna i (ponteiros válidos até ga_result_free) */
+GACAPI_EXPORT int ga_result_column_info(const ga_result *r, int i,
+                                        const char **table, const char **name,
+                                        int *type, long long *length);
+/* dados da coluna, sem cópia; 0 = ok, -1 se não existir */
+GACAPI_EXPORT int ga_result_column(const ga_result *r, const char *table, const char *name,
+                                   const void **data, int *type, long long *length);
+
+/* grava as colunas no formato .gacol (ver gacolumns.h); 0 = ok */
+GACAPI_EXPORT int ga_result_write_columnar(const ga_result *r, const char *path);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* GACAPI_H */
@@ -0,0 +1,22 @@
+// gacli.cpp
+#include "gacli.h"
+
+#include <QFile>
+#include <QJsonDocument>
+
+QString argValue(const QStringList &args, const QString &name, const QString &def)
+{
+    int i = args.indexOf(name);
+    if (i >= 0 && i + 1 < args.size())
+        return args[i + 1];
+    return def;
+}
+
+bool writeJson(const QString &path, const QJsonDocument &doc)
+{
+    QFile f(path);
+    if (!f.open(QIODevice::WriteOnly))
+        return false;
+    f.write(doc.toJson(QJsonDocument::Indented));
+    return true;
+}
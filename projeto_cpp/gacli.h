@@ -0,0 +1,19 @@
+// gacli.h
+#ifndef GACLI_H
+#define GACLI_H
+
+#include <QString>
+#include <QStringList>
+
+class QJsonDocument;
+
+// Utilitários comuns dos modos headless (--bench, --batch, --sweep,
+// --perf-check, --recover, --robust, --serve)
+
+// valor que segue a opção name em args ("--port 8470"), ou def
+QString argValue(const QStringList &args, const QString &name, const QString &def);
+
+// grava o documento indentado; false se o arquivo não abrir
+bool writeJson(const QString &path, const QJsonDocument &doc);
+
+#endif // GACLI_H
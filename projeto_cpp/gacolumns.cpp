@@ -0,0 +1,224 @@
+// gacolumns.cpp
+#include "gacolumns.h"
+
+#include <QFile>
+#include <QJsonObject>
+#include <QtEndian>
+#include <QVariantList>
+
+int ResultColumns::indexOf(const QByteArray &table, const QByteArray &name) const
+{
+    for (int i = 0; i < columns.size(); ++i) {
+        if (columns[i].table == table && columns[i].name == name)
+            return i;
+    }
+    return -1;
+}
+
+namespace {
+
+void addColumn(ResultColumns &out, const char *table, const char *name,
+               bool isFloat, int reserve)
+{
+    ResultColumn c;
+    c.table = table;
+    c.name = name;
+    c.isFloat = isFloat;
+    if (isFloat) c.reals.reserve(reserve);
+    else         c.ints.reserve(reserve);
+    out.columns.append(c);
+}
+
+template <class T>
+void appendLE(QByteArray &out, T v)
+{
+    char buf[sizeof(T)];
+    qToLittleEndian<T>(v, buf);
+    out.append(buf, int(sizeof(T)));
+}
+
+void appendName(QByteArray &out, const QByteArray &name)
+{
+    appendLE<quint16>(out, quint16(name.size()));
+    out.append(name);
+}
+
+constexpr qint64 ColumnAlign = 64;
+
+qint64 alignUp(qint64 v)
+{
+    return (v + ColumnAlign - 1) / ColumnAlign * ColumnAlign;
+}
+
+} // namespace
+
+ResultColumns resultColumns(const GAResult &result)
+{
+    ResultColumns out;
+
+    // flights
+    {
+        const QVector<FlightInstance> &fl = result.bestFlights;
+        const int n = fl.size();
+        const int first = out.columns.size();
+        addColumn(out, "flights", "tmpl_id", false, n);
+        addColumn(out, "flights", "route_id", false, n);
+        addColumn(out, "flights", "orig_id", false, n);
+        addColumn(out, "flights", "dest_id", false, n);
+        addColumn(out, "flights", "dep_min", false, n);
+        addColumn(out, "flights", "arr_min", false, n);
+        addColumn(out, "flights", "aircraft_idx", false, n);
+        addColumn(out, "flights", "capacity", false, n);
+        addColumn(out, "flights", "used_seats", false, n);
+        addColumn(out, "flights", "type_idx", false, n);
+        ResultColumn *c = out.columns.data() + first;
+        for (const FlightInstance &f : fl) {
+            c[0].ints.append(f.tmplId);
+            c[1].ints.append(f.routeId);
+            c[2].ints.append(f.orig);
+            c[3].ints.append(f.dest);
+            c[4].ints.append(f.depMin);
+            c[5].ints.append(f.arrMin);
+            c[6].ints.append(f.aircraftIdx);
+            c[7].ints.append(f.capacity);
+            c[8].ints.append(f.usedSeats);
+            c[9].ints.append(f.typeIdx);
+        }
+    }
+
+    // assignments + legs
+    {
+        const QVector<QVariantMap> &pa = result.bestPaxAssignments;
+        const int n = pa.size();
+        const int first = out.columns.size();
+        addColumn(out, "assignments", "orig_id", false, n);
+        addColumn(out, "assignments", "dest_id", false, n);
+        addColumn(out, "assignments", "pax", false, n);
+        addColumn(out, "assignments", "num_legs", false, n);
+        addColumn(out, "assignments", "dep_min", false, n);
+        addColumn(out, "assignments", "arr_min", false, n);
+        addColumn(out, "assignments", "leg_begin", false, n);
+        addColumn(out, "assignments", "leg_end", false, n);
+        const int firstLeg = out.columns.size();
+        addColumn(out, "legs", "assignment", false, 2 * n);
+        addColumn(out, "legs", "flight_index", false, 2 * n);
+        addColumn(out, "legs", "route_id", false, 2 * n);
+        addColumn(out, "legs", "orig_id", false, 2 * n);
+        addColumn(out, "legs", "dest_id", false, 2 * n);
+        addColumn(out, "legs", "dep_min", false, 2 * n);
+        addColumn(out, "legs", "arr_min", false, 2 * n);
+        addColumn(out, "legs", "aircraft_idx", false, 2 * n);
+        ResultColumn *c = out.columns.data() + first;
+        ResultColumn *l = out.columns.data() + firstLeg;
+        for (int i = 0; i < n; ++i) {
+            const QVariantMap &rec = pa[i];
+            c[0].ints.append(rec.value("orig_id").toInt());
+            c[1].ints.append(rec.value("dest_id").toInt());
+            c[2].ints.append(rec.value("pax").toInt());
+            c[3].ints.append(rec.value("num_legs").toInt());
+            c[4].ints.append(rec.value("dep_min").toInt());
+            c[5].ints.append(rec.value("arr_min").toInt());
+            c[6].ints.append(l[0].ints.size());
+            const QVariantList legs = rec.value("legs").toList();
+            for (const QVariant &lv : legs) {
+                const QVariantMap leg = lv.toMap();
+                l[0].ints.append(i);
+                l[1].ints.append(leg.value("flight_index").toInt());
+                l[2].ints.append(leg.value("route_id").toInt());
+                l[3].ints.append(leg.value("orig_id").toInt());
+                l[4].ints.append(leg.value("dest_id").toInt());
+                l[5].ints.append(leg.value("dep_min").toInt());
+                l[6].ints.append(leg.value("arr_min").toInt());
+                l[7].ints.append(leg.value("aircraft_idx").toInt());
+            }
+            c[7].ints.append(l[0].ints.size());
+        }
+    }
+
+    // history
+    {
+        static const char *const intFields[] = {
+            "generation", "served_total", "unserved", "num_flights", "used_aircraft"
+        };
+        static const char *const realFields[] = {
+            "best_score", "avg_score", "worst_score", "duration_ms", "gap",
+            "diversity_hamming", "gene_entropy", "duplicate_rate"
+        };
+        const int n = result.history.size();
+        const int first = out.columns.size();
+        for (const char *f : intFields)
+            addColumn(out, "history", f, false, n);
+        for (const char *f : realFields)
+            addColumn(out, "history", f, true, n);
+        ResultColumn *c = out.columns.data() + first;
+        const int numInt = int(sizeof(intFields) / sizeof(intFields[0]));
+        const int numReal = int(sizeof(realFields) / sizeof(realFields[0]));
+        for (const QJsonValue &v : result.history) {
+            const QJsonObject g = v.toObject();
+            for (int k = 0; k < numInt; ++k)
+                c[k].ints.append(g.value(intFields[k]).toInt());
+            for (int k = 0; k < numReal; ++k)
+                c[numInt + k].reals.append(g.value(realFields[k]).toDouble());
+        }
+    }
+
+    return out;
+}
+
+bool writeColumnar(const QString &path, const ResultColumns &cols, QString &error)
+{
+    // diretório primeiro (tamanho fixo depois dos nomes), depois os offsets
+    qint64 headerSize = 16;
+    for (const ResultColumn &c : cols.columns)
+        headerSize += 2 + c.table.size() + 2 + c.name.size() + 1 + 8 + 8;
+
+    QVector<qint64> offsets(cols.columns.size());
+    qint64 pos = alignUp(headerSize);
+    for (int i = 0; i < cols.columns.size(); ++i) {
+        const ResultColumn &c = cols.columns[i];
+        offsets[i] = pos;
+        pos = alignUp(pos + qint64(c.size()) * (c.isFloat ? 8 : 4));
+    }
+
+    QByteArray header;
+    header.reserve(int(alignUp(headerSize)));
+    header.append("GACOL\0\0\0", 8);
+    appendLE<quint32>(header, 1);
+    appendLE<quint32>(header, quint32(cols.columns.size()));
+    for (int i = 0; i < cols.columns.size(); ++i) {
+        const ResultColumn &c = cols.columns[i];
+        appendName(header, c.table);
+        appendName(header, c.name);
+        header.append(char(c.isFloat ? 2 : 1));
+        appendLE<quint64>(header, quint64(c.size()));
+        appendLE<quint64>(header, quint64(offsets[i]));
+    }
+
+    QFile f(path);
+    if (!f.open(QIODevice::WriteOnly)) {
+        error = QString("Cannot write %1").arg(path);
+        return false;
+    }
+    f.write(header);
+    for (int i = 0; i < cols.columns.size(); ++i) {
+        const ResultColumn &c = cols.columns[i];
+        const QByteArray pad(int(offsets[i] - f.pos()), '\0');
+        f.write(pad);
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+        f.write(static_cast<const char *>(c.data()), qint64(c.size()) * (c.isFloat ? 8 : 4));
+#else
+        QByteArray le;
+        if (c.isFloat) {
+            for (double v : c.reals) appendLE<double>(le, v);
+        } else {
+            for (qint32 v : c.ints) appendLE<qint32>(le, v);
+        }
+        f.write(le);
+#endif
+    }
+    if (f.error() != QFileDevice::NoError) {
+        error = QString("Error writing %1: %2").arg(path, f.errorString());
+        return false;
+    }
+    return true;
+}
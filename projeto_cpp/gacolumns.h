@@ -0,0 +1,62 @@
+// gacolumns.h
+#ifndef GACOLUMNS_H
+#define GACOLUMNS_H
+
+#include "gaengine.h"
+
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+
+// Resultado do GA em colunas (uma por campo, tipos fixos), sem passar por
+// texto: base dos bindings Python e da saída colunar.
+//
+// Tabelas:
+//   flights      um registro por voo de GAResult::bestFlights (mesma ordem;
+//                leg.flight_index aponta para esta tabela)
+//   assignments  um registro por grupo OD alocado; leg_begin/leg_end
+//                delimitam as pernas do grupo na tabela legs
+//   legs         pernas dos itinerários, na ordem dos grupos
+//   history      uma linha por geração (ga_stats.json "evolution")
+struct ResultColumn {
+    QByteArray table;
+    QByteArray name;
+    bool isFloat = false;        // float64; senão int32
+    QVector<qint32> ints;
+    QVector<double> reals;
+
+    int size() const { return isFloat ? reals.size() : ints.size(); }
+    const void *data() const
+    {
+        return isFloat ? static_cast<const void *>(reals.constData())
+                       : static_cast<const void *>(ints.constData());
+    }
+};
+
+struct ResultColumns {
+    QVector<ResultColumn> columns;
+
+    // índice da coluna ou -1
+    int indexOf(const QByteArray &table, const QByteArray &name) const;
+};
+
+ResultColumns resultColumns(const GAResult &result);
+
+// Arquivo colunar (.gacol), pensado para np.memmap sem parse:
+//
+//   0   char[8]  magic "GACOL\0\0\0"
+//   8   u32      versão (1)
+//   12  u32      número de colunas N
+//   16  N entradas do diretório, cada uma:
+//         u16 len + bytes   tabela (UTF-8)
+//         u16 len + bytes   coluna (UTF-8)
+//         u8               tipo (1 = int32, 2 = float64)
+//         u64              número de valores
+//         u64              offset dos dados desde o início do arquivo
+//   dados de cada coluna, contíguos, alinhados em 64 bytes
+//
+// Tudo little-endian. Leitor de referência: read_columnar() em
+// python/aeroportos_ga.py.
+bool writeColumnar(const QString &path, const ResultColumns &cols, QString &error);
+
+#endif // GACOLUMNS_H
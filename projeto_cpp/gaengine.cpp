@@ -1,19 +1,50 @@
 #include "gaengine.h"
+#include "gajsonstream.h"
+#include "gametrics.h"
+#include "gatrace.h"
+#include "paxrouter.h"
 
 #include <QFile>
+#include <QFileInfo>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonArray>
 #include <QRandomGenerator>
+#include <QRunnable>
+#include <QThreadPool>
 #include <QtMath>
 #include <QSet>
+#include <QHash>
+#include <QtAlgorithms>
 #include <QElapsedTimer>
+#include <QVarLengthArray>
+
+#include <algorithm>
+#include <array>
+#include <climits>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <numeric>
+#include <vector>
 
 GAEngine::GAEngine(QObject *parent)
     : QObject(parent)
+    , m_data(new ScenarioData)
+    , m_rng(QRandomGenerator::global()->generate())
 {
 }
 
+void GAEngine::setGAParams(const GAParams &params)
+{
+    m_gaParams = params;
+    m_gaParams.pCross         = qBound(0.0, params.pCross, 1.0);
+    m_gaParams.pMut           = qBound(0.0, params.pMut, 1.0);
+    m_gaParams.eliteFrac      = qBound(0.0, params.eliteFrac, 1.0);
+    m_gaParams.tournamentSize = qMax(1, params.tournamentSize);
+}
+
 bool GAEngine::loadData(const QString &airportsPath,
                         const QString &routesPath,
                         const QString &passengersPath,
@@ -21,160 +52,1192 @@ bool GAEngine::loadData(const QString &airportsPath,
                         const QString &forbiddenPath,
                         QString &error)
 {
-    m_airports.clear();
-    m_routes.clear();
-    m_od.clear();
-    m_allFlights.clear();
-    m_fleet = FleetInfo();
-    m_forbiddenOD.clear();
-
-    auto loadJson = [](const QString &path, QJsonDocument &doc, QString &err) -> bool {
-        QFile f(path);
-        if (!f.open(QIODevice::ReadOnly)) {
-            err = QString("Cannot open %1").arg(path);
-            return false;
-        }
-        QByteArray data = f.readAll();
-        f.close();
-        QJsonParseError pe;
-        doc = QJsonDocument::fromJson(data, &pe);
-        if (pe.error != QJsonParseError::NoError) {
-            err = QString("JSON parse error in %1: %2")
-            .arg(path, pe.errorString());
+    GA_TRACE_SCOPE("loadData", "setup");
+    ScenarioPtr data = loadScenario(airportsPath, routesPath, passengersPath,
+                                    fleetPath, forbiddenPath, error);
+    if (!data)
+        return false;
+    setScenario(data);
+    return true;
+}
+
+namespace {
+
+// fleet.json como está no arquivo; validado em loadScenario
+struct FleetInput {
+    struct Type {
+        QString name;
+        int seats = 0;
+        int count = 0;
+        QStringList ids;
+    };
+    int numAircraft = 0;
+    int seatsPerAircraft = 0;
+    QStringList aircraftIds;
+    QVector<Type> types;
+};
+
+bool readStringList(JsonStreamReader &r, QStringList &out)
+{
+    return r.readArray([&]() {
+        QString s;
+        if (!r.readString(s))
             return false;
-        }
+        out.append(s);
         return true;
-    };
+    });
+}
 
-    QJsonDocument docAir, docRt, docPax, docFleet, docForbidden;
+// percorre o objeto raiz e chama item() para cada elemento de arrayKey
+bool readRootArray(JsonStreamReader &r, const char *arrayKey, const std::function<bool()> &item)
+{
+    return r.readObject([&](const QByteArray &key) {
+        return key == arrayKey ? r.readArray(item) : r.skipValue();
+    });
+}
 
-    if (!loadJson(airportsPath, docAir, error)) return false;
-    if (!loadJson(routesPath, docRt, error)) return false;
-    if (!loadJson(passengersPath, docPax, error)) return false;
-    if (!loadJson(fleetPath, docFleet, error)) return false;
-    if (!loadJson(forbiddenPath, docForbidden, error)) return false;
+bool parseAirports(JsonStreamReader &r, QVector<Airport> &out)
+{
+    return readRootArray(r, "airports", [&]() {
+        Airport a{};
+        const bool ok = r.readObject([&](const QByteArray &k) {
+            if (k == "id")   return r.readInt(a.id);
+            if (k == "code") return r.readString(a.code);
+            if (k == "name") return r.readString(a.name);
+            if (k == "lat")  return r.readDouble(a.lat);
+            if (k == "lon")  return r.readDouble(a.lon);
+            return r.skipValue();
+        });
+        out.append(a);
+        return ok;
+    });
+}
 
-    // airports.json
-    QJsonArray arrAir = docAir.object().value("airports").toArray();
-    if (arrAir.isEmpty()) {
-        error = "airports.json: missing 'airports' array";
+bool parseRoutes(JsonStreamReader &r, QVector<Route> &out)
+{
+    return readRootArray(r, "routes", [&]() {
+        Route rt{};
+        const bool ok = r.readObject([&](const QByteArray &k) {
+            if (k == "id")       return r.readInt(rt.id);
+            if (k == "orig_id")  return r.readInt(rt.orig);
+            if (k == "dest_id")  return r.readInt(rt.dest);
+            if (k == "time_min") return r.readInt(rt.timeMin);
+            return r.skipValue();
+        });
+        out.append(rt);
+        return ok;
+    });
+}
+
+bool parseDemand(JsonStreamReader &r, QVector<ODDemand> &out)
+{
+    return readRootArray(r, "od_pairs", [&]() {
+        ODDemand d{};
+        const bool ok = r.readObject([&](const QByteArray &k) {
+            if (k == "orig_id") return r.readInt(d.orig);
+            if (k == "dest_id") return r.readInt(d.dest);
+            if (k == "demand")  return r.readInt(d.demand);
+            return r.skipValue();
+        });
+        out.append(d);
+        return ok;
+    });
+}
+
+bool parseFleet(JsonStreamReader &r, FleetInput &f)
+{
+    return r.readObject([&](const QByteArray &key) {
+        if (key == "num_aircraft")       return r.readInt(f.numAircraft);
+        if (key == "seats_per_aircraft") return r.readInt(f.seatsPerAircraft);
+        if (key == "aircraft_ids")       return readStringList(r, f.aircraftIds);
+        if (key != "aircraft_types")
+            return r.skipValue();
+        return r.readArray([&]() {
+            FleetInput::Type t;
+            const bool ok = r.readObject([&](const QByteArray &k) {
+                if (k == "type")         return r.readString(t.name);
+                if (k == "seats")        return r.readInt(t.seats);
+                if (k == "count")        return r.readInt(t.count);
+                if (k == "aircraft_ids") return readStringList(r, t.ids);
+                return r.skipValue();
+            });
+            f.types.append(t);
+            return ok;
+        });
+    });
+}
+
+// forbidden_routes.json (pares OD proibidos)
+bool parseForbidden(JsonStreamReader &r, QSet<quint64> &out)
+{
+    return readRootArray(r, "forbidden_od", [&]() {
+        int orig = 0, dest = 0;
+        const bool ok = r.readObject([&](const QByteArray &k) {
+            if (k == "orig_id") return r.readInt(orig);
+            if (k == "dest_id") return r.readInt(dest);
+            return r.skipValue();
+        });
+        if (orig >= 0 && dest >= 0)
+            out.insert(GAEngine::odKey(orig, dest));
+        return ok;
+    });
+}
+
+// lê um arquivo inteiro com parse(); mede bytes e tempo
+bool streamJson(const QString &path, InputFileStats &stats, QString &err,
+                const std::function<bool(JsonStreamReader &)> &parse)
+{
+    GA_TRACE_SCOPE("parseInput", "setup");
+    QElapsedTimer timer;
+    timer.start();
+    stats.file = QFileInfo(path).fileName();
+    QFile f(path);
+    if (!f.open(QIODevice::ReadOnly)) {
+        err = QString("Cannot open %1").arg(path);
         return false;
     }
-    for (const QJsonValue &v : arrAir) {
-        QJsonObject o = v.toObject();
-        Airport a;
-        a.id   = o.value("id").toInt();
-        a.code = o.value("code").toString();
-        a.name = o.value("name").toString();
-        a.lat  = o.value("lat").toDouble();
-        a.lon  = o.value("lon").toDouble();
-        m_airports.append(a);
-    }
-
-    // routes.json
-    QJsonArray arrRt = docRt.object().value("routes").toArray();
-    if (arrRt.isEmpty()) {
-        error = "routes.json: missing 'routes' array";
+    JsonStreamReader r(&f);
+    const bool ok = parse(r) && r.next() == JsonStreamReader::EndOfInput;
+    stats.bytes   = r.bytesRead();
+    stats.parseMs = timer.nsecsElapsed() / 1e6;
+    if (!ok) {
+        err = QString("JSON parse error in %1: %2")
+                  .arg(path, r.hasError() ? r.errorString() : QString("unexpected content"));
         return false;
     }
-    for (const QJsonValue &v : arrRt) {
-        QJsonObject o = v.toObject();
-        Route r;
-        r.id      = o.value("id").toInt();
-        r.orig    = o.value("orig_id").toInt();
-        r.dest    = o.value("dest_id").toInt();
-        r.timeMin = o.value("time_min").toInt();
-        m_routes.append(r);
+    return true;
+}
+
+} // namespace
+
+ScenarioPtr GAEngine::loadScenario(const QString &airportsPath,
+                                   const QString &routesPath,
+                                   const QString &passengersPath,
+                                   const QString &fleetPath,
+                                   const QString &forbiddenPath,
+                                   QString &error)
+{
+    GA_TRACE_SCOPE("loadScenario", "setup");
+    QSharedPointer<ScenarioData> sd(new ScenarioData);
+
+    // as cinco entradas são lidas em paralelo, cada uma pelo leitor
+    // incremental direto para o seu campo do cenário (sem DOM)
+    FleetInput fleetIn;
+    QSet<quint64> *forbidden = &sd->forbiddenOD;
+    sd->inputStats.resize(5);
+    InputFileStats *stats = sd->inputStats.data();
+    QString errs[5];
+    bool oks[5] = { false, false, false, false, false };
+    const std::function<bool(int)> parsers[5] = {
+        [&](int i) { return streamJson(airportsPath, stats[i], errs[i],
+                                       [&](JsonStreamReader &r) { return parseAirports(r, sd->airports); }); },
+        [&](int i) { return streamJson(routesPath, stats[i], errs[i],
+                                       [&](JsonStreamReader &r) { return parseRoutes(r, sd->routes); }); },
+        [&](int i) { return streamJson(passengersPath, stats[i], errs[i],
+                                       [&](JsonStreamReader &r) { return parseDemand(r, sd->od); }); },
+        [&](int i) { return streamJson(fleetPath, stats[i], errs[i],
+                                       [&](JsonStreamReader &r) { return parseFleet(r, fleetIn); }); },
+        [&](int i) { return streamJson(forbiddenPath, stats[i], errs[i],
+                                       [&](JsonStreamReader &r) { return parseForbidden(r, *forbidden); }); },
+    };
+    {
+        QThreadPool pool;
+        pool.setMaxThreadCount(5);
+        for (int i = 0; i < 5; ++i)
+            pool.start(QRunnable::create([&parsers, &oks, i]() { oks[i] = parsers[i](i); }));
+        pool.waitForDone();
     }
+    for (int i = 0; i < 5; ++i) {
+        if (!oks[i]) {
+            error = errs[i];
+            return ScenarioPtr();
+        }
+    }
+    sd->routes.squeeze();
+    sd->od.squeeze();
 
-    // passengers_od.json
-    QJsonArray arrPax = docPax.object().value("od_pairs").toArray();
-    if (arrPax.isEmpty()) {
+    if (sd->airports.isEmpty()) {
+        error = "airports.json: missing 'airports' array";
+        return ScenarioPtr();
+    }
+    if (sd->routes.isEmpty()) {
+        error = "routes.json: missing 'routes' array";
+        return ScenarioPtr();
+    }
+    if (sd->od.isEmpty()) {
         error = "passengers_od.json: missing 'od_pairs' array";
-        return false;
+        return ScenarioPtr();
     }
-    for (const QJsonValue &v : arrPax) {
-        QJsonObject o = v.toObject();
-        ODDemand d;
-        d.orig   = o.value("orig_id").toInt();
-        d.dest   = o.value("dest_id").toInt();
-        d.demand = o.value("demand").toInt();
-        m_od.append(d);
+
+    // fleet.json: frota homogênea (num_aircraft / seats_per_aircraft) ou
+    // lista aircraft_types [{type, seats, count, aircraft_ids?}]
+    if (fleetIn.types.isEmpty()) {
+        AircraftType t;
+        t.seats         = fleetIn.seatsPerAircraft;
+        t.count         = fleetIn.numAircraft;
+        t.firstAircraft = 0;
+        sd->fleet.types.append(t);
+        sd->fleet.aircraftIds = fleetIn.aircraftIds;
+        while (sd->fleet.aircraftIds.size() > t.count)
+            sd->fleet.aircraftIds.removeLast();
+    } else {
+        for (const FleetInput::Type &ti : fleetIn.types) {
+            AircraftType t;
+            t.name          = ti.name;
+            t.seats         = ti.seats;
+            t.count         = ti.count;
+            t.firstAircraft = sd->fleet.aircraftIds.size();
+            if (t.name.isEmpty() || t.seats <= 0 || t.count < 0) {
+                error = QString("%1: each aircraft type needs 'type', 'seats' > 0 and 'count' >= 0")
+                            .arg(fleetPath);
+                return ScenarioPtr();
+            }
+            for (int i = 0; i < t.count; ++i) {
+                sd->fleet.aircraftIds.append(i < ti.ids.size()
+                    ? ti.ids[i]
+                    : QString("%1_%2").arg(t.name).arg(i, 3, 10, QChar('0')));
+            }
+            sd->fleet.types.append(t);
+        }
+    }
+    sd->fleet.numAircraft      = 0;
+    sd->fleet.seatsPerAircraft = 0;
+    for (const AircraftType &t : sd->fleet.types) {
+        sd->fleet.numAircraft     += t.count;
+        sd->fleet.seatsPerAircraft = qMax(sd->fleet.seatsPerAircraft, t.seats);
+    }
+    if (sd->fleet.aircraftIds.size() < sd->fleet.numAircraft) {
+        for (int i = sd->fleet.aircraftIds.size(); i < sd->fleet.numAircraft; ++i)
+            sd->fleet.aircraftIds.append(QString("AC_%1").arg(i, 3, 10, QChar('0')));
     }
 
-    // fleet.json
-    QJsonObject objF = docFleet.object();
-    m_fleet.numAircraft      = objF.value("num_aircraft").toInt();
-    m_fleet.seatsPerAircraft = objF.value("seats_per_aircraft").toInt();
-    QJsonArray arrIds = objF.value("aircraft_ids").toArray();
-    for (const QJsonValue &v : arrIds) {
-        m_fleet.aircraftIds.append(v.toString());
+    // meta.json (opcional, ao lado do arquivo de passageiros): parâmetros
+    // de tempo do cenário; sem ele valem os defaults de GAConst
+    const QString metaPath = QFileInfo(passengersPath).absolutePath() + "/meta.json";
+    if (QFile::exists(metaPath) && !loadScenarioParams(metaPath, sd->params, error))
+        return ScenarioPtr();
+
+    // slots.json (opcional, idem): capacidade por hora e toque de recolher
+    const QString slotsPath = QFileInfo(passengersPath).absolutePath() + "/slots.json";
+    if (QFile::exists(slotsPath) && !loadSlotLimits(slotsPath, *sd, error))
+        return ScenarioPtr();
+
+    buildAllFlights(*sd);
+    buildSlotIndex(*sd);
+    buildGeneBlocks(*sd);
+
+    if (sd->allFlights.isEmpty()) {
+        error = "No feasible flights built from routes/slots.";
+        return ScenarioPtr();
+    }
+
+    // kernel de tamanho fixo só se todos os ids cabem nas matrizes
+    sd->fixedKernelAvailable = (sd->airports.size() <= GAConst::MaxFixedAirports);
+    for (const Route &r : sd->routes) {
+        if (r.orig >= GAConst::MaxFixedAirports || r.dest >= GAConst::MaxFixedAirports)
+            sd->fixedKernelAvailable = false;
     }
-    if (m_fleet.aircraftIds.size() < m_fleet.numAircraft) {
-        for (int i = m_fleet.aircraftIds.size(); i < m_fleet.numAircraft; ++i)
-            m_fleet.aircraftIds.append(QString("AC_%1").arg(i, 3, 10, QChar('0')));
+    for (const ODDemand &d : sd->od) {
+        if (d.orig >= GAConst::MaxFixedAirports || d.dest >= GAConst::MaxFixedAirports)
+            sd->fixedKernelAvailable = false;
     }
 
-    // forbidden_routes.json (pares OD proibidos)
-    QJsonArray arrForb = docForbidden.object().value("forbidden_od").toArray();
-    for (const QJsonValue &v : arrForb) {
-        QJsonObject o = v.toObject();
-        int orig = o.value("orig_id").toInt();
-        int dest = o.value("dest_id").toInt();
-        if (orig >= 0 && dest >= 0) {
-            m_forbiddenOD.insert(odKey(orig, dest));
+    return sd;
+}
+
+void GAEngine::setScenario(const ScenarioPtr &data, const ScenarioOverlay &overlay)
+{
+    m_data    = data ? data : ScenarioPtr(new ScenarioData);
+    m_overlay = overlay;
+    m_useFixedKernel = m_data->fixedKernelAvailable;
+    clearWarmStart();
+    clearFrozenGenes();
+    m_acGroundedFrom.clear();
+
+    // demanda efetiva da variação (por dia)
+    const QVector<ODDemand> &od = m_data->od;
+    m_odDemand = QVector<int>(od.size(), 0);
+    for (int i = 0; i < od.size(); ++i) {
+        double scale = overlay.demandScale;
+        if (!overlay.odDemandScale.isEmpty())
+            scale *= overlay.odDemandScale.value(odKey(od[i].orig, od[i].dest), 1.0);
+        m_odDemand[i] = qMax(0, qRound(od[i].demand * scale));
+    }
+
+    // genes de pares proibidos só pela variação
+    m_geneBlocked.clear();
+    if (!overlay.forbiddenOD.isEmpty()) {
+        const QVector<FlightTemplate> &all = m_data->allFlights;
+        m_geneBlocked = QVector<char>(all.size(), 0);
+        for (int g = 0; g < all.size(); ++g)
+            if (overlay.forbiddenOD.contains(odKey(all[g].orig, all[g].dest)))
+                m_geneBlocked[g] = 1;
+    }
+
+    // demanda agregada por aeroporto (limites da pré-triagem)
+    const int A = m_data->airports.size();
+    m_demandFrom = QVector<long long>(A, 0);
+    m_demandTo   = QVector<long long>(A, 0);
+    m_totalDemand = 0;
+    for (int i = 0; i < od.size(); ++i) {
+        const ODDemand &d = od[i];
+        const long long dem = 1LL * m_odDemand[i] * m_data->params.numDays;
+        if (d.orig >= 0 && d.orig < A) m_demandFrom[d.orig] += dem;
+        if (d.dest >= 0 && d.dest < A) m_demandTo[d.dest] += dem;
+        m_totalDemand += dem;
+    }
+
+    computeUpperBound();
+}
+
+void GAEngine::blockGenes(const QVector<int> &genes)
+{
+    if (m_geneBlocked.isEmpty())
+        m_geneBlocked = QVector<char>(m_data->allFlights.size(), 0);
+    for (int g : genes)
+        if (g >= 0 && g < m_geneBlocked.size()) m_geneBlocked[g] = 1;
+}
+
+void GAEngine::setFrozenGenes(const QVector<int> &forcedOn, const QVector<int> &forcedOff)
+{
+    const int n = m_data->allFlights.size();
+    m_frozen = QVector<char>(n, 0);
+    for (int g : forcedOff)
+        if (g >= 0 && g < n) m_frozen[g] = 2;
+    for (int g : forcedOn)
+        if (g >= 0 && g < n) m_frozen[g] = 1;
+    m_frozenOn.clear();
+    m_frozenOff.clear();
+    m_freeGenes.clear();
+    for (int g = 0; g < n; ++g) {
+        if (m_frozen[g] == 1)      m_frozenOn.append(g);
+        else if (m_frozen[g] == 2) m_frozenOff.append(g);
+        else                       m_freeGenes.append(g);
+    }
+}
+
+void GAEngine::clearFrozenGenes()
+{
+    m_frozen.clear();
+    m_frozenOn.clear();
+    m_frozenOff.clear();
+    m_freeGenes.clear();
+}
+
+bool GAEngine::isForbidden(int orig, int dest) const
+{
+    const quint64 key = odKey(orig, dest);
+    return m_data->forbiddenOD.contains(key) || m_overlay.forbiddenOD.contains(key);
+}
+
+// Limite superior do score por relaxação: ignora a alocação de aeronaves
+// (turnaround, posição) e a disputa de assentos entre pares OD, mantendo
+// só o orçamento total de assento-minutos da frota:
+//   sum_od S_od * t_od <= aeronaves * assentos * minutos de operação
+// onde t_od é o menor tempo de voo (soma das rotas permitidas) de um
+// itinerário que cabe na janela de operação. O tempo de viagem de cada
+// passageiro é >= t_od, então
+//   score <= sum_od (150000 - 10 t_od) S_od - 50000 * demanda
+// e o máximo sai de uma mochila fracionária (menor t_od primeiro).
+void GAEngine::computeUpperBound()
+{
+    GA_TRACE_SCOPE("computeUpperBound", "setup");
+    const int A = m_data->airports.size();
+    const int conn = m_data->params.minConnMin;
+    const int window = (m_data->params.numDays - 1) * GAConst::MinutesPerDay
+                       + (m_data->params.dayEnd - m_data->params.dayStart);
+    const int INF = INT_MAX / 2;
+
+    // menor tempo de rota direta permitido por par
+    QVector<QVector<int>> hop(A, QVector<int>(A, INF));
+    for (const Route &r : m_data->routes) {
+        if (r.orig < 0 || r.orig >= A || r.dest < 0 || r.dest >= A) continue;
+        if (isForbidden(r.orig, r.dest)) continue;
+        if (r.timeMin > m_data->params.dayEnd - m_data->params.dayStart) continue;
+        hop[r.orig][r.dest] = qMin(hop[r.orig][r.dest], r.timeMin);
+    }
+
+    // exact[o][v]: menor tempo de voo com exatamente k pernas; um
+    // itinerário real de k pernas dura pelo menos isso + (k-1) conexões
+    QVector<QVector<int>> best(A, QVector<int>(A, INF));
+    QVector<QVector<int>> exact = hop;
+    for (int k = 1; k < A; ++k) {
+        bool any = false;
+        for (int o = 0; o < A; ++o) {
+            for (int v = 0; v < A; ++v) {
+                if (exact[o][v] + (k - 1) * conn <= window) {
+                    best[o][v] = qMin(best[o][v], exact[o][v]);
+                    any = true;
+                }
+            }
         }
+        if (!any) break;
+        QVector<QVector<int>> nextExact(A, QVector<int>(A, INF));
+        for (int o = 0; o < A; ++o)
+            for (int u = 0; u < A; ++u) {
+                if (exact[o][u] >= INF) continue;
+                for (int v = 0; v < A; ++v)
+                    if (hop[u][v] < INF)
+                        nextExact[o][v] = qMin(nextExact[o][v], exact[o][u] + hop[u][v]);
+            }
+        exact.swap(nextExact);
+    }
+
+    struct Item { int t; long long demand; };
+    QVector<Item> items;
+    for (int i = 0; i < m_data->od.size(); ++i) {
+        const ODDemand &d = m_data->od[i];
+        if (d.orig < 0 || d.orig >= A || d.dest < 0 || d.dest >= A) continue;
+        const int t = best[d.orig][d.dest];
+        if (t >= INF || m_odDemand[i] <= 0) continue;
+        items.append({t, 1LL * m_odDemand[i] * m_data->params.numDays});
+    }
+    std::sort(items.begin(), items.end(),
+              [](const Item &a, const Item &b) { return a.t < b.t; });
+
+    double seats = 0.0;
+    for (const AircraftType &t : m_data->fleet.types)
+        seats += (double)t.count * t.seats;
+    double budget = seats * m_data->params.numDays
+                    * (m_data->params.dayEnd - m_data->params.dayStart);
+    double served = 0.0;
+    double value  = 0.0;
+    for (const Item &it : items) {
+        if (budget <= 0.0) break;
+        const double take = qMin((double)it.demand, budget / it.t);
+        served += take;
+        value  += take * (150000.0 - 10.0 * it.t);
+        budget -= take * it.t;
     }
 
-    buildAllFlights();
+    m_servedUpperBound = (long long)std::floor(served);
+    m_scoreUpperBound  = value - 50000.0 * (double)m_totalDemand;
+}
 
-    if (m_allFlights.isEmpty()) {
-        error = "No feasible flights built from routes/slots.";
+double GAEngine::optimalityGap(double score) const
+{
+    return (m_scoreUpperBound - score) / qMax(1.0, std::fabs(m_scoreUpperBound));
+}
+
+bool GAEngine::loadScenarioParams(const QString &metaPath, ScenarioParams &params,
+                                  QString &error)
+{
+    QFile f(metaPath);
+    if (!f.open(QIODevice::ReadOnly)) {
+        error = QString("Cannot open %1").arg(metaPath);
+        return false;
+    }
+    QJsonParseError pe;
+    QJsonDocument doc = QJsonDocument::fromJson(f.readAll(), &pe);
+    f.close();
+    if (pe.error != QJsonParseError::NoError) {
+        error = QString("JSON parse error in %1: %2").arg(metaPath, pe.errorString());
+        return false;
+    }
+
+    QJsonObject o = doc.object();
+    ScenarioParams p;
+    p.dayStart      = o.value("day_start").toInt(p.dayStart);
+    p.dayEnd        = o.value("day_end").toInt(p.dayEnd);
+    p.slotMin       = o.value("slot_min").toInt(p.slotMin);
+    p.turnaroundMin = o.value("turnaround_min").toInt(p.turnaroundMin);
+    p.minConnMin    = o.value("min_conn_min").toInt(p.minConnMin);
+    p.numDays       = o.value("num_days").toInt(p.numDays);
+    const QString layout = o.value("gene_layout").toString("route");
+    if (layout == "airport_time") {
+        p.geneLayout = GeneLayout::AirportTime;
+    } else if (layout != "route") {
+        error = QString("meta.json: unknown gene_layout '%1' (route, airport_time)").arg(layout);
         return false;
     }
 
+    if (p.slotMin <= 0 || p.numDays <= 0 || p.turnaroundMin < 0 || p.minConnMin < 0
+        || p.dayStart < 0 || p.dayEnd <= p.dayStart
+        || p.dayEnd > GAConst::MinutesPerDay) {
+        error = QString("meta.json: invalid time parameters in %1").arg(metaPath);
+        return false;
+    }
+
+    params = p;
     return true;
 }
 
-void GAEngine::buildAllFlights()
+// Formato do slots.json:
+// { "airports": [ { "id": 0,
+//                   "dep_per_hour": 12,            // ou [24 valores]
+//                   "arr_per_hour": [ ... ],
+//                   "curfews": [ { "from_min": 1380, "to_min": 360 } ] } ] }
+bool GAEngine::loadSlotLimits(const QString &slotsPath, ScenarioData &data,
+                              QString &error)
 {
-    m_allFlights.clear();
-    const int DAY_START = 6 * 60;
-    const int DAY_END   = 22 * 60;
-    const int SLOT_MIN  = 60;
+    QFile f(slotsPath);
+    if (!f.open(QIODevice::ReadOnly)) {
+        error = QString("Cannot open %1").arg(slotsPath);
+        return false;
+    }
+    QJsonParseError pe;
+    QJsonDocument doc = QJsonDocument::fromJson(f.readAll(), &pe);
+    f.close();
+    if (pe.error != QJsonParseError::NoError) {
+        error = QString("JSON parse error in %1: %2").arg(slotsPath, pe.errorString());
+        return false;
+    }
+
+    auto perHour = [](const QJsonValue &v) {
+        QVector<int> out(24, -1);
+        if (v.isDouble()) {
+            out.fill(v.toInt());
+        } else if (v.isArray()) {
+            const QJsonArray a = v.toArray();
+            for (int h = 0; h < 24 && h < a.size(); ++h)
+                out[h] = a[h].isNull() ? -1 : a[h].toInt(-1);
+        }
+        return out;
+    };
+
+    for (const QJsonValue &v : doc.object().value("airports").toArray()) {
+        const QJsonObject o = v.toObject();
+        const int id = o.value("id").toInt(-1);
+        if (id < 0) {
+            error = QString("%1: airport entry without 'id'").arg(slotsPath);
+            return false;
+        }
+        AirportSlotLimits lim;
+        lim.depPerHour = perHour(o.value("dep_per_hour"));
+        lim.arrPerHour = perHour(o.value("arr_per_hour"));
+        for (const QJsonValue &cv : o.value("curfews").toArray()) {
+            const QJsonObject co = cv.toObject();
+            const int from = co.value("from_min").toInt(-1);
+            const int to   = co.value("to_min").toInt(-1);
+            if (from < 0 || to < 0 || from > GAConst::MinutesPerDay || to > GAConst::MinutesPerDay) {
+                error = QString("%1: invalid curfew window for airport %2").arg(slotsPath).arg(id);
+                return false;
+            }
+            lim.curfews.append(qMakePair(from, to));
+        }
+        data.slotLimits.insert(id, lim);
+    }
+    return true;
+}
+
+namespace {
+
+// minuto (absoluto no horizonte) dentro de algum toque de recolher
+bool inCurfew(const ScenarioData &data, int airport, int minute)
+{
+    auto it = data.slotLimits.constFind(airport);
+    if (it == data.slotLimits.constEnd()) return false;
+    const AirportSlotLimits *lim = &it.value();
+    const int m = minute % GAConst::MinutesPerDay;
+    for (const QPair<int, int> &w : lim->curfews) {
+        const bool inside = (w.first <= w.second) ? (m >= w.first && m < w.second)
+                                                  : (m >= w.first || m < w.second);
+        if (inside) return true;
+    }
+    return false;
+}
+
+} // namespace
+
+void GAEngine::buildAllFlights(ScenarioData &data)
+{
+    GA_TRACE_SCOPE("buildAllFlights", "setup");
+    data.allFlights.clear();
+    const int DAY_START = data.params.dayStart;
+    const int DAY_END   = data.params.dayEnd;
+    const int SLOT_MIN  = data.params.slotMin;
+    const int numTypes  = qMax(1, data.fleet.types.size());
 
     int idCounter = 0;
-    for (const Route &r : m_routes) {
+    data.curfewFiltered = 0;
+    for (const Route &r : data.routes) {
         // ignora completamente rotas proibidas: nunca geram genes
-        if (m_forbiddenOD.contains(odKey(r.orig, r.dest)))
+        if (data.forbiddenOD.contains(odKey(r.orig, r.dest)))
+            continue;
+        for (int day = 0; day < data.params.numDays; ++day) {
+            const int base = day * GAConst::MinutesPerDay;
+            for (int dep = DAY_START; dep < DAY_END; dep += SLOT_MIN) {
+                int arr = dep + r.timeMin;
+                if (arr > DAY_END) continue;
+                // partida ou chegada em toque de recolher: nunca vira gene
+                if (!data.slotLimits.isEmpty()
+                    && (inCurfew(data, r.orig, base + dep) || inCurfew(data, r.dest, base + arr))) {
+                    data.curfewFiltered += numTypes;
+                    continue;
+                }
+                // um gene por tipo de aeronave (frota homogênea: um só)
+                for (int t = 0; t < numTypes; ++t) {
+                    FlightTemplate ft;
+                    ft.id      = idCounter++;
+                    ft.routeId = r.id;
+                    ft.orig    = r.orig;
+                    ft.dest    = r.dest;
+                    ft.depMin  = base + dep;
+                    ft.arrMin  = base + arr;
+                    ft.typeIdx = t;
+                    data.allFlights.append(ft);
+                }
+            }
+        }
+    }
+
+    // ordem alternativa: origem, partida (e, no empate, a ordem por rota)
+    if (data.params.geneLayout == GeneLayout::AirportTime) {
+        std::stable_sort(data.allFlights.begin(), data.allFlights.end(),
+                         [](const FlightTemplate &a, const FlightTemplate &b) {
+                             return a.orig != b.orig ? a.orig < b.orig : a.depMin < b.depMin;
+                         });
+        for (int g = 0; g < data.allFlights.size(); ++g)
+            data.allFlights[g].id = g;
+    }
+}
+
+void GAEngine::buildGeneBlocks(ScenarioData &data)
+{
+    data.geneBlocks.clear();
+    data.geneTimeBlocks.clear();
+    const QVector<FlightTemplate> &all = data.allFlights;
+    const bool byAirport = (data.params.geneLayout == GeneLayout::AirportTime);
+    int prevKey = -1, prevWindow = -1;
+    for (int g = 0; g < all.size(); ++g) {
+        const int key    = byAirport ? all[g].orig : all[g].routeId;
+        const int window = all[g].depMin / GAConst::CrossoverTimeBlockMin;
+        if (g == 0 || key != prevKey)
+            data.geneBlocks.append(g);
+        if (g == 0 || key != prevKey || window != prevWindow)
+            data.geneTimeBlocks.append(g);
+        prevKey    = key;
+        prevWindow = window;
+    }
+    data.geneBlocks.append(all.size());
+    data.geneTimeBlocks.append(all.size());
+}
+
+ScenarioPtr GAEngine::withGeneLayout(const ScenarioPtr &data, GeneLayout layout)
+{
+    if (!data || data->params.geneLayout == layout)
+        return data;
+    QSharedPointer<ScenarioData> sd(new ScenarioData(*data));
+    sd->params.geneLayout = layout;
+    buildAllFlights(*sd);
+    buildSlotIndex(*sd);
+    buildGeneBlocks(*sd);
+    return sd;
+}
+
+void GAEngine::buildSlotIndex(ScenarioData &data)
+{
+    data.geneDepSlot.clear();
+    data.geneArrSlot.clear();
+    data.slotCapacity.clear();
+    if (data.slotLimits.isEmpty())
+        return;
+
+    // slot = (aeroporto, hora do horizonte, partida/chegada); só os que têm
+    // limite recebem índice
+    QHash<quint64, int> slotIndex;
+    auto slotFor = [&](int airport, int minute, bool arrival) -> int {
+        auto it = data.slotLimits.constFind(airport);
+        if (it == data.slotLimits.constEnd()) return -1;
+        const int hourOfDay = (minute % GAConst::MinutesPerDay) / 60;
+        const int cap = arrival ? it->arrPerHour[hourOfDay] : it->depPerHour[hourOfDay];
+        if (cap < 0) return -1;
+        const quint64 key = ((quint64)(quint32)airport << 32)
+                            | ((quint64)(minute / 60) << 1) | (arrival ? 1 : 0);
+        auto found = slotIndex.constFind(key);
+        if (found != slotIndex.constEnd()) return found.value();
+        const int idx = data.slotCapacity.size();
+        data.slotCapacity.append(cap);
+        slotIndex.insert(key, idx);
+        return idx;
+    };
+
+    const int n = data.allFlights.size();
+    data.geneDepSlot = QVector<int>(n, -1);
+    data.geneArrSlot = QVector<int>(n, -1);
+    for (int g = 0; g < n; ++g) {
+        const FlightTemplate &ft = data.allFlights[g];
+        data.geneDepSlot[g] = slotFor(ft.orig, ft.depMin, false);
+        data.geneArrSlot[g] = slotFor(ft.dest, ft.arrMin, true);
+    }
+}
+
+bool GAEngine::loadWarmStart(const QString &flightsPath, QString &error)
+{
+    clearWarmStart();
+    if (m_data->allFlights.isEmpty()) {
+        error = "Warm start requires loaded scenario data.";
+        return false;
+    }
+
+    QFile f(flightsPath);
+    if (!f.open(QIODevice::ReadOnly)) {
+        error = QString("Cannot open %1").arg(flightsPath);
+        return false;
+    }
+    QJsonParseError pe;
+    QJsonDocument doc = QJsonDocument::fromJson(f.readAll(), &pe);
+    f.close();
+    if (pe.error != QJsonParseError::NoError) {
+        error = QString("JSON parse error in %1: %2").arg(flightsPath, pe.errorString());
+        return false;
+    }
+    QJsonArray arrFl = doc.object().value("flights").toArray();
+    if (arrFl.isEmpty()) {
+        error = QString("%1: missing 'flights' array").arg(flightsPath);
+        return false;
+    }
+
+    // tmpl_id muda quando forbidden_routes.json muda (a numeração dos genes
+    // pula rotas proibidas), então o voo é localizado por (orig,dest,partida)
+    // e tipo de aeronave (aircraft_type; sem ele, o primeiro tipo)
+    auto slotKey = [](int orig, int dest, int dep, int type) -> quint64 {
+        return ((quint64)orig << 48) | ((quint64)dest << 32)
+               | ((quint64)type << 24) | (quint32)(dep & 0xFFFFFF);
+    };
+    QHash<quint64, int> geneBySlot;
+    geneBySlot.reserve(m_data->allFlights.size());
+    for (const FlightTemplate &ft : m_data->allFlights)
+        geneBySlot.insert(slotKey(ft.orig, ft.dest, ft.depMin, ft.typeIdx), ft.id);
+    QHash<QString, int> typeByName;
+    for (int t = 0; t < m_data->fleet.types.size(); ++t)
+        typeByName.insert(m_data->fleet.types[t].name, t);
+
+    QSet<int> seen;
+    for (const QJsonValue &v : arrFl) {
+        QJsonObject o = v.toObject();
+        const int orig = o.value("orig_id").toInt(-1);
+        const int dest = o.value("dest_id").toInt(-1);
+        const int dep  = o.value("dep_min").toInt(-1);
+        const int type = o.contains("aircraft_type")
+                             ? typeByName.value(o.value("aircraft_type").toString(), -1) : 0;
+        int gene = -1;
+        if (orig >= 0 && dest >= 0 && dep >= 0 && type >= 0)
+            gene = geneBySlot.value(slotKey(orig, dest, dep, type), -1);
+        if (gene < 0 || isForbidden(orig, dest)) {
+            ++m_warmStartDropped; // template não existe mais
             continue;
-        for (int dep = DAY_START; dep <= (21 * 60); dep += SLOT_MIN) {
-            int arr = dep + r.timeMin;
-            if (arr > DAY_END) continue;
-            FlightTemplate ft;
-            ft.id      = idCounter++;
-            ft.routeId = r.id;
-            ft.orig    = r.orig;
-            ft.dest    = r.dest;
-            ft.depMin  = dep;
-            ft.arrMin  = arr;
-            m_allFlights.append(ft);
+        }
+        if (!seen.contains(gene)) {
+            seen.insert(gene);
+            m_warmStart.append(gene);
         }
     }
+
+    if (m_warmStart.isEmpty()) {
+        error = QString("%1: no flight matches the current templates").arg(flightsPath);
+        return false;
+    }
+    std::sort(m_warmStart.begin(), m_warmStart.end());
+    return true;
 }
 
-quint64 GAEngine::odKey(int orig, int dest) const
+void GAEngine::clearWarmStart()
+{
+    m_warmStart.clear();
+    m_warmStartDropped = 0;
+}
+
+quint64 GAEngine::odKey(int orig, int dest)
 {
     return ( (quint64)orig << 32 ) | (quint64)(dest & 0xffffffff);
 }
 
-QVector<QVector<bool>> GAEngine::initPopulation(int popSize, int numGenes)
+namespace {
+
+// Percorre em ordem crescente as posições de [0, n) sorteadas cada uma com
+// probabilidade p, pulando direto de uma à próxima (distância geométrica)
+template <class F>
+void forEachBernoulli(int n, double p, QRandomGenerator *rng, F f)
+{
+    if (p <= 0.0)
+        return;
+    if (p >= 1.0) {
+        for (int i = 0; i < n; ++i)
+            f(i);
+        return;
+    }
+    const double logQ = std::log(1.0 - p);
+    double pos = std::floor(std::log(1.0 - rng->generateDouble()) / logQ);
+    while (pos < n) {
+        f((int)pos);
+        pos += 1.0 + std::floor(std::log(1.0 - rng->generateDouble()) / logQ);
+    }
+}
+
+// Crossover por blocos: um bit sorteado por bloco (troca ou não) e
+// f(lo, hi, swap) para cada trecho máximo de blocos consecutivos com o
+// mesmo sorteio; offsets = ScenarioData::geneBlocks / geneTimeBlocks
+template <class F>
+void forEachBlockRun(const QVector<int> &offsets, QRandomGenerator *rng, F f)
+{
+    const int blocks = offsets.size() - 1;
+    quint64 bits = 0;
+    int runStart = 0;
+    bool runSwap = false;
+    for (int i = 0; i < blocks; ++i) {
+        if ((i & 63) == 0)
+            bits = rng->generate64();
+        const bool swap = (bits >> (i & 63)) & 1;
+        if (i > 0 && swap != runSwap) {
+            f(offsets[runStart], offsets[i], runSwap);
+            runStart = i;
+        }
+        runSwap = swap;
+    }
+    if (blocks > 0)
+        f(offsets[runStart], offsets[blocks], runSwap);
+}
+
+template <class F>
+void forEachActive(const QVector<bool> &ind, F f)
 {
-    QVector<QVector<bool>> pop;
+    const int n = ind.size();
+    for (int g = 0; g < n; ++g)
+        if (ind[g]) f(g);
+}
+
+template <class F>
+void forEachActive(const QVector<int> &ind, F f)
+{
+    for (int g : ind)
+        f(g);
+}
+
+int activeCount(const QVector<bool> &ind)
+{
+    return std::count(ind.constBegin(), ind.constEnd(), true);
+}
+
+int activeCount(const QVector<int> &ind)
+{
+    return ind.size();
+}
+
+// copia para um buffer já existente (reaproveita a capacidade do destino)
+template <class Chrom>
+void copyChromosome(Chrom &dst, const Chrom &src)
+{
+    dst.resize(src.size());
+    std::copy(src.constBegin(), src.constEnd(), dst.begin());
+}
+
+// Diversidade da população (ga_stats.json): distância de Hamming média
+// em pares sorteados, entropia média das frequências de alelo dos genes
+// presentes em algum indivíduo e fração de indivíduos repetidos
+struct PopDiversity {
+    double hamming   = 0.0;   // genes diferentes por par
+    double relative  = 0.0;   // hamming / genes ativos médios
+    double entropy   = 0.0;   // bits, 0 = todos iguais, 1 = metade/metade
+    double duplicate = 0.0;
+};
+
+// 8 bools (bytes 0/1) viram 8 bits com uma multiplicação
+void packBits(const QVector<bool> &ind, quint64 *words, int numWords)
+{
+    const int n = ind.size();
+    const bool *b = ind.constData();
+    std::fill(words, words + numWords, 0);
+    int g = 0;
+    for (; g + 8 <= n; g += 8) {
+        quint64 x;
+        std::memcpy(&x, b + g, 8);
+        words[g >> 6] |= ((x * 0x0102040810204080ULL) >> 56) << (g & 63);
+    }
+    for (; g < n; ++g)
+        if (b[g]) words[g >> 6] |= quint64(1) << (g & 63);
+}
+
+double binaryEntropy(double p)
+{
+    if (p <= 0.0 || p >= 1.0) return 0.0;
+    return -(p * std::log2(p) + (1.0 - p) * std::log2(1.0 - p));
+}
+
+// pares: todos se forem poucos, senão 4 por indivíduo; gerador próprio
+// (semeado pela geração) para não mexer na sequência do GA
+QVector<QPair<int, int>> diversityPairs(int popSize, int gen)
+{
+    QVector<QPair<int, int>> pairs;
+    if (popSize < 2) return pairs;
+    const long long all = (long long)popSize * (popSize - 1) / 2;
+    if (all <= 4LL * popSize) {
+        for (int a = 0; a < popSize; ++a)
+            for (int b = a + 1; b < popSize; ++b)
+                pairs.append(qMakePair(a, b));
+        return pairs;
+    }
+    QRandomGenerator rng(0x5EEDu + quint32(gen));
+    for (int k = 0; k < 4 * popSize; ++k) {
+        const int a = rng.bounded(popSize);
+        int b = rng.bounded(popSize - 1);
+        if (b >= a) ++b;
+        pairs.append(qMakePair(a, b));
+    }
+    return pairs;
+}
+
+PopDiversity measureDiversity(const QVector<QVector<bool>> &pop, int gen)
+{
+    PopDiversity d;
+    const int P = pop.size();
+    if (P == 0) return d;
+    const int n = pop[0].size();
+    const int W = (n + 63) / 64;
+
+    thread_local QVector<quint64> words;
+    words.resize(P * W);
+    for (int i = 0; i < P; ++i)
+        packBits(pop[i], words.data() + (qint64)i * W, W);
+
+    const QVector<QPair<int, int>> pairs = diversityPairs(P, gen);
+    long long dist = 0;
+    for (const QPair<int, int> &pr : pairs) {
+        const quint64 *a = words.constData() + (qint64)pr.first * W;
+        const quint64 *b = words.constData() + (qint64)pr.second * W;
+        for (int w = 0; w < W; ++w)
+            dist += qPopulationCount(a[w] ^ b[w]);
+    }
+    long long active = 0;
+    for (int w = 0; w < P * W; ++w)
+        active += qPopulationCount(words[w]);
+
+    // frequência de alelo: soma vertical dos bytes
+    thread_local QVector<int> ones;
+    ones.fill(0, n);
+    for (const QVector<bool> &ind : pop) {
+        const bool *b = ind.constData();
+        int *o = ones.data();
+        for (int g = 0; g < n; ++g)
+            o[g] += b[g];
+    }
+    double hsum = 0.0;
+    int present = 0;
+    for (int g = 0; g < n; ++g) {
+        if (ones[g] == 0) continue;
+        ++present;
+        hsum += binaryEntropy((double)ones[g] / P);
+    }
+
+    // repetidos: hash das palavras, igualdade só dentro do mesmo hash
+    QVector<QPair<size_t, int>> hashes(P);
+    for (int i = 0; i < P; ++i)
+        hashes[i] = { qHashBits(words.constData() + (qint64)i * W, W * sizeof(quint64)), i };
+    std::sort(hashes.begin(), hashes.end());
+    int dups = 0;
+    for (int i = 1; i < P; ++i) {
+        for (int j = i - 1; j >= 0 && hashes[j].first == hashes[i].first; --j) {
+            if (std::equal(words.constData() + (qint64)hashes[i].second * W,
+                           words.constData() + (qint64)hashes[i].second * W + W,
+                           words.constData() + (qint64)hashes[j].second * W)) {
+                ++dups;
+                break;
+            }
+        }
+    }
+
+    d.hamming   = pairs.isEmpty() ? 0.0 : (double)dist / pairs.size();
+    d.relative  = active > 0 ? d.hamming / ((double)active / P) : 0.0;
+    d.entropy   = present > 0 ? hsum / present : 0.0;
+    d.duplicate = (double)dups / P;
+    return d;
+}
+
+PopDiversity measureDiversity(const QVector<QVector<int>> &pop, int gen)
+{
+    PopDiversity d;
+    const int P = pop.size();
+    if (P == 0) return d;
+
+    // |A xor B| = |A| + |B| - 2 |A e B| (listas ordenadas)
+    const QVector<QPair<int, int>> pairs = diversityPairs(P, gen);
+    long long dist = 0;
+    for (const QPair<int, int> &pr : pairs) {
+        const QVector<int> &a = pop[pr.first];
+        const QVector<int> &b = pop[pr.second];
+        int common = 0;
+        for (int i = 0, j = 0; i < a.size() && j < b.size();) {
+            if (a[i] < b[j]) ++i;
+            else if (b[j] < a[i]) ++j;
+            else { ++common; ++i; ++j; }
+        }
+        dist += a.size() + b.size() - 2 * common;
+    }
+    long long active = 0;
+    QHash<int, int> ones;
+    for (const QVector<int> &ind : pop) {
+        active += ind.size();
+        for (int g : ind)
+            ++ones[g];
+    }
+    double hsum = 0.0;
+    for (auto it = ones.constBegin(); it != ones.constEnd(); ++it)
+        hsum += binaryEntropy((double)it.value() / P);
+
+    QVector<QPair<size_t, int>> hashes(P);
+    for (int i = 0; i < P; ++i)
+        hashes[i] = { qHashBits(pop[i].constData(), pop[i].size() * sizeof(int)), i };
+    std::sort(hashes.begin(), hashes.end());
+    int dups = 0;
+    for (int i = 1; i < P; ++i) {
+        for (int j = i - 1; j >= 0 && hashes[j].first == hashes[i].first; --j) {
+            if (pop[hashes[i].second] == pop[hashes[j].second]) {
+                ++dups;
+                break;
+            }
+        }
+    }
+
+    d.hamming   = pairs.isEmpty() ? 0.0 : (double)dist / pairs.size();
+    d.relative  = active > 0 ? d.hamming / ((double)active / P) : 0.0;
+    d.entropy   = ones.isEmpty() ? 0.0 : hsum / ones.size();
+    d.duplicate = (double)dups / P;
+    return d;
+}
+
+// NSGA-II: objetivos todos em forma de minimização, mais a violação de
+// restrição (voos acima do teto); menor violação domina sempre
+struct MOPoint {
+    double f[3] = {0.0, 0.0, 0.0};
+    double viol = 0.0;
+};
+
+bool moDominates(const MOPoint &a, const MOPoint &b)
+{
+    if (a.viol != b.viol) return a.viol < b.viol;
+    bool strictly = false;
+    for (int m = 0; m < 3; ++m) {
+        if (a.f[m] > b.f[m]) return false;
+        if (a.f[m] < b.f[m]) strictly = true;
+    }
+    return strictly;
+}
+
+// Ordenação não-dominada eficiente (ENS-SS): em ordem lexicográfica
+// (violação, f0, f1, f2) um ponto só pode ser dominado por quem vem antes,
+// então basta procurar a primeira frente sem dominador, comparando de trás
+// para frente (os últimos da frente são os mais parecidos)
+void nonDominatedSort(const QVector<MOPoint> &pts, const QVector<int> &ids,
+                      QVector<int> &rank, QVector<QVector<int>> &fronts)
+{
+    QVector<int> order = ids;
+    std::sort(order.begin(), order.end(), [&](int a, int b) {
+        const MOPoint &pa = pts[a];
+        const MOPoint &pb = pts[b];
+        if (pa.viol != pb.viol) return pa.viol < pb.viol;
+        for (int m = 0; m < 3; ++m)
+            if (pa.f[m] != pb.f[m]) return pa.f[m] < pb.f[m];
+        return a < b;
+    });
+
+    fronts.clear();
+    for (int id : order) {
+        int k = 0;
+        for (; k < fronts.size(); ++k) {
+            const QVector<int> &F = fronts[k];
+            bool dominated = false;
+            for (int j = F.size() - 1; j >= 0 && !dominated; --j)
+                dominated = moDominates(pts[F[j]], pts[id]);
+            if (!dominated) break;
+        }
+        if (k == fronts.size()) fronts.append(QVector<int>());
+        fronts[k].append(id);
+        rank[id] = k;
+    }
+}
+
+void crowdingDistance(const QVector<MOPoint> &pts, const QVector<int> &front,
+                      QVector<double> &crowd)
+{
+    const double inf = std::numeric_limits<double>::infinity();
+    for (int id : front) crowd[id] = 0.0;
+    if (front.size() <= 2) {
+        for (int id : front) crowd[id] = inf;
+        return;
+    }
+    QVector<int> s = front;
+    for (int m = 0; m < 3; ++m) {
+        std::sort(s.begin(), s.end(),
+                  [&](int a, int b) { return pts[a].f[m] < pts[b].f[m]; });
+        const double lo = pts[s.first()].f[m];
+        const double hi = pts[s.last()].f[m];
+        crowd[s.first()] = inf;
+        crowd[s.last()]  = inf;
+        if (hi - lo <= 0.0) continue;
+        for (int j = 1; j + 1 < s.size(); ++j)
+            crowd[s[j]] += (pts[s[j + 1]].f[m] - pts[s[j - 1]].f[m]) / (hi - lo);
+    }
+}
+
+} // namespace
+
+// Estimativa barata (sem alocar aeronaves nem rotear) de um limite
+// superior do score. Todo passageiro servido embarca num voo que sai da
+// sua origem e desembarca num que chega ao seu destino, então
+//   servidos <= min( sum_o min(demanda_o, assentos saindo de o),
+//                    sum_d min(demanda_d, assentos chegando em d) )
+// e, como tempo de viagem e voos vazios só descontam, o score fica abaixo
+// de 100000*servidos - 50000*(demanda - servidos). No modo Surrogate
+// desconta-se ainda a penalidade de voos acima de GAConst::MaxFlights
+// supondo que todos os genes ativos viram voos (não é garantido: voos
+// sem aeronave ou podados não contam).
+template <class Chrom>
+double GAEngine::screenEstimate(const Chrom &ind) const
+{
+    const int A = m_data->airports.size();
+    const QVector<AircraftType> &types = m_data->fleet.types;
+    QVarLengthArray<long long, GAConst::MaxFixedAirports> seatsOut(A), seatsIn(A);
+    std::fill(seatsOut.begin(), seatsOut.end(), 0);
+    std::fill(seatsIn.begin(), seatsIn.end(), 0);
+
+    int active = 0;
+    forEachActive(ind, [&](int g) {
+        const FlightTemplate &ft = m_data->allFlights[g];
+        const int seats = types[ft.typeIdx].seats;
+        seatsOut[ft.orig] += seats;
+        seatsIn[ft.dest]  += seats;
+        ++active;
+    });
+
+    long long boundOut = 0, boundIn = 0;
+    for (int a = 0; a < A; ++a) {
+        boundOut += qMin(m_demandFrom[a], seatsOut[a]);
+        boundIn  += qMin(m_demandTo[a], seatsIn[a]);
+    }
+    const long long served = qMin(boundOut, boundIn);
+
+    double est = 100000.0 * served - 50000.0 * (double)(m_totalDemand - served);
+    if (m_screening == ScreeningMode::Surrogate && active > GAConst::MaxFlights)
+        est -= 100000.0 * (active - GAConst::MaxFlights);
+    return est;
+}
+
+void GAEngine::initPopulation(QVector<QVector<bool>> &pop, int popSize) const
+{
+    const int numGenes = m_data->allFlights.size();
+    pop.clear();
     pop.reserve(popSize);
-    QRandomGenerator *rng = QRandomGenerator::global();
+    QRandomGenerator *rng = &m_rng;
+
+    // warm start: a solução anterior intacta + metade da população com
+    // variantes mutadas dela; o resto continua aleatório para diversidade
+    int seeded = 0;
+    if (!m_warmStart.isEmpty()) {
+        QVector<bool> seed(numGenes, false);
+        for (int g : m_warmStart)
+            if (g < numGenes) seed[g] = true;
+        pop.append(seed);
+        const int variants = popSize / 2;
+        for (int i = 1; i < variants; ++i) {
+            QVector<bool> ind(numGenes);
+            std::copy(seed.constBegin(), seed.constEnd(), ind.begin());
+            mutate(ind, 0.01);
+            pop.append(ind);
+        }
+        seeded = pop.size();
+    }
 
-    for (int i = 0; i < popSize; ++i) {
+    for (int i = seeded; i < popSize; ++i) {
         QVector<bool> ind(numGenes);
         for (int g = 0; g < numGenes; ++g) {
             // probabilidade baixa de ativar voo (começa esparso)
@@ -182,37 +1245,228 @@ QVector<QVector<bool>> GAEngine::initPopulation(int popSize, int numGenes)
         }
         pop.append(ind);
     }
-    return pop;
+
+    if (!m_frozen.isEmpty())
+        for (QVector<bool> &ind : pop) applyFrozen(ind);
+}
+
+void GAEngine::initPopulation(QVector<QVector<int>> &pop, int popSize) const
+{
+    const int numGenes = m_data->allFlights.size();
+    pop.clear();
+    pop.reserve(popSize);
+    QRandomGenerator *rng = &m_rng;
+
+    int seeded = 0;
+    if (!m_warmStart.isEmpty()) {
+        pop.append(m_warmStart);
+        const int variants = popSize / 2;
+        for (int i = 1; i < variants; ++i) {
+            QVector<int> ind;
+            copyChromosome(ind, m_warmStart);
+            mutate(ind, 0.01);
+            pop.append(ind);
+        }
+        seeded = pop.size();
+    }
+
+    // mesma densidade inicial do modo denso, sorteando só os genes ativos
+    for (int i = seeded; i < popSize; ++i) {
+        QVector<int> ind;
+        ind.reserve(qMax(16, (int)(numGenes * 0.02 * 1.2)));
+        forEachBernoulli(numGenes, 0.02, rng, [&](int g) { ind.append(g); });
+        pop.append(ind);
+    }
+
+    if (!m_frozen.isEmpty())
+        for (QVector<int> &ind : pop) applyFrozen(ind);
 }
 
 void GAEngine::crossover(const QVector<bool> &p1, const QVector<bool> &p2,
                          QVector<bool> &c1, QVector<bool> &c2,
                          double pCross) const
 {
-    QRandomGenerator *rng = QRandomGenerator::global();
+    // c1/c2 são buffers pré-alocados da próxima geração: os filhos são
+    // montados no lugar, sem cópia intermediária dos pais
+    QRandomGenerator *rng = &m_rng;
     const int n = p1.size();
-    c1 = p1;
-    c2 = p2;
-    if (rng->generateDouble() >= pCross || n < 2) {
+    c1.resize(n);
+    c2.resize(n);
+
+    const bool *a = p1.constData();
+    const bool *b = p2.constData();
+    bool *x = c1.data();
+    bool *y = c2.data();
+    const bool cross = rng->generateDouble() < pCross && n >= 2;
+
+    const QVector<int> &blocks = (m_crossoverMode == CrossoverMode::TimeBlocks)
+                                     ? m_data->geneTimeBlocks : m_data->geneBlocks;
+    if (cross && m_crossoverMode != CrossoverMode::OnePoint && blocks.size() >= 2) {
+        // trechos consecutivos do mesmo pai viram uma cópia contígua só
+        forEachBlockRun(blocks, rng, [&](int lo, int hi, bool swap) {
+            std::copy(a + lo, a + hi, (swap ? y : x) + lo);
+            std::copy(b + lo, b + hi, (swap ? x : y) + lo);
+        });
         return;
     }
-    int point = rng->bounded(1, n-1);
-    for (int i = point; i < n; ++i) {
-        bool t = c1[i];
-        c1[i] = c2[i];
-        c2[i] = t;
+
+    int point = n;
+    if (cross)
+        point = rng->bounded(1, n-1);
+    std::copy(a, a + point, x);
+    std::copy(b + point, b + n, x + point);
+    std::copy(b, b + point, y);
+    std::copy(a + point, a + n, y + point);
+}
+
+void GAEngine::crossover(const QVector<int> &p1, const QVector<int> &p2,
+                         QVector<int> &c1, QVector<int> &c2,
+                         double pCross) const
+{
+    // mesmo corte de um ponto do modo denso, no espaço de ids de genes:
+    // cada filho = prefixo (< point) de um pai + sufixo (>= point) do outro
+    QRandomGenerator *rng = &m_rng;
+    const int n = m_data->allFlights.size();
+    const int *a = p1.constData();
+    const int *b = p2.constData();
+    const bool cross = rng->generateDouble() < pCross && n >= 2;
+
+    const QVector<int> &blocks = (m_crossoverMode == CrossoverMode::TimeBlocks)
+                                     ? m_data->geneTimeBlocks : m_data->geneBlocks;
+    if (cross && m_crossoverMode != CrossoverMode::OnePoint && blocks.size() >= 2) {
+        // por blocos: o trecho [lo, hi) de ids de cada pai é localizado a
+        // partir do fim do trecho anterior
+        c1.resize(0);
+        c2.resize(0);
+        int k1 = 0, k2 = 0;
+        forEachBlockRun(blocks, rng, [&](int, int hi, bool swap) {
+            const int e1 = std::lower_bound(a + k1, a + p1.size(), hi) - a;
+            const int e2 = std::lower_bound(b + k2, b + p2.size(), hi) - b;
+            QVector<int> &fromA = swap ? c2 : c1;
+            QVector<int> &fromB = swap ? c1 : c2;
+            for (int k = k1; k < e1; ++k) fromA.append(a[k]);
+            for (int k = k2; k < e2; ++k) fromB.append(b[k]);
+            k1 = e1;
+            k2 = e2;
+        });
+        return;
     }
+
+    int point = n;
+    if (cross)
+        point = rng->bounded(1, n-1);
+
+    const int k1 = std::lower_bound(p1.constBegin(), p1.constEnd(), point) - p1.constBegin();
+    const int k2 = std::lower_bound(p2.constBegin(), p2.constEnd(), point) - p2.constBegin();
+
+    c1.resize(k1 + (p2.size() - k2));
+    c2.resize(k2 + (p1.size() - k1));
+    std::copy(b + k2, b + p2.size(), std::copy(a, a + k1, c1.data()));
+    std::copy(a + k1, a + p1.size(), std::copy(b, b + k2, c2.data()));
 }
 
 void GAEngine::mutate(QVector<bool> &ind, double pMut) const
 {
-    QRandomGenerator *rng = QRandomGenerator::global();
-    const int n = ind.size();
-    for (int i = 0; i < n; ++i) {
-        if (rng->generateDouble() < pMut) {
-            ind[i] = !ind[i];
-        }
+    // sorteia direto a distância até o próximo gene mutado (geométrica),
+    // em vez de um número aleatório por gene
+    bool *bits = ind.data();
+    if (!m_frozen.isEmpty()) {
+        // genes fixos: sorteia só entre os livres
+        const int *freeGenes = m_freeGenes.constData();
+        forEachBernoulli(m_freeGenes.size(), pMut, &m_rng,
+                         [bits, freeGenes](int i) { bits[freeGenes[i]] = !bits[freeGenes[i]]; });
+        return;
+    }
+    forEachBernoulli(ind.size(), pMut, &m_rng,
+                     [bits](int i) { bits[i] = !bits[i]; });
+}
+
+void GAEngine::mutate(QVector<int> &ind, double pMut) const
+{
+    // posições sorteadas (já ordenadas) são trocadas de estado com uma
+    // diferença simétrica contra a lista ativa; os buffers de trabalho são
+    // por thread e trocados com o indivíduo, sem alocação em regime
+    thread_local QVector<int> flips;
+    thread_local QVector<int> merged;
+    flips.clear();
+    if (!m_frozen.isEmpty()) {
+        const int *freeGenes = m_freeGenes.constData();
+        forEachBernoulli(m_freeGenes.size(), pMut, &m_rng,
+                         [freeGenes](int i) { flips.append(freeGenes[i]); });
+    } else {
+        forEachBernoulli(m_data->allFlights.size(), pMut, &m_rng,
+                         [](int g) { flips.append(g); });
+    }
+    if (flips.isEmpty())
+        return;
+
+    merged.resize(ind.size() + flips.size());
+    int *end = std::set_symmetric_difference(ind.constBegin(), ind.constEnd(),
+                                             flips.constBegin(), flips.constEnd(),
+                                             merged.data());
+    merged.resize(end - merged.data());
+    ind.swap(merged);
+}
+
+void GAEngine::removeGenes(QVector<bool> &ind, QVector<int> &genes) const
+{
+    for (int g : genes)
+        if (m_frozen.isEmpty() || m_frozen[g] != 1)
+            ind[g] = false;
+}
+
+void GAEngine::removeGenes(QVector<int> &ind, QVector<int> &genes) const
+{
+    if (!m_frozen.isEmpty()) {
+        // genes fixos ligados não são reparados
+        auto end = std::remove_if(genes.begin(), genes.end(),
+                                  [this](int g) { return m_frozen[g] == 1; });
+        genes.resize(end - genes.begin());
     }
+    std::sort(genes.begin(), genes.end());
+    auto end = std::remove_if(ind.begin(), ind.end(), [&](int g) {
+        return std::binary_search(genes.constBegin(), genes.constEnd(), g);
+    });
+    ind.resize(end - ind.begin());
+}
+
+void GAEngine::immigrant(QVector<bool> &ind, double density) const
+{
+    ind.fill(false, m_data->allFlights.size());
+    bool *bits = ind.data();
+    forEachBernoulli(ind.size(), density, &m_rng, [bits](int g) { bits[g] = true; });
+    if (!m_frozen.isEmpty())
+        applyFrozen(ind);
+}
+
+void GAEngine::immigrant(QVector<int> &ind, double density) const
+{
+    ind.clear();
+    forEachBernoulli(m_data->allFlights.size(), density, &m_rng,
+                     [&ind](int g) { ind.append(g); });
+    if (!m_frozen.isEmpty())
+        applyFrozen(ind);
+}
+
+void GAEngine::applyFrozen(QVector<bool> &ind) const
+{
+    bool *bits = ind.data();
+    for (int g : m_frozenOn)  bits[g] = true;
+    for (int g : m_frozenOff) bits[g] = false;
+}
+
+void GAEngine::applyFrozen(QVector<int> &ind) const
+{
+    thread_local QVector<int> merged;
+    auto end = std::remove_if(ind.begin(), ind.end(),
+                              [this](int g) { return m_frozen[g] == 2; });
+    ind.resize(end - ind.begin());
+    merged.resize(ind.size() + m_frozenOn.size());
+    int *last = std::set_union(ind.constBegin(), ind.constEnd(),
+                               m_frozenOn.constBegin(), m_frozenOn.constEnd(),
+                               merged.data());
+    merged.resize(last - merged.data());
+    ind.swap(merged);
 }
 
 QString GAEngine::formatTimeHHMM(int minutes) const
@@ -223,26 +1477,347 @@ QString GAEngine::formatTimeHHMM(int minutes) const
         .arg(m, 2, 10, QChar('0'));
 }
 
+namespace {
+
+// Faixa contígua de índices de voos (em ordem de partida) de um par OD
+struct IdxSpan {
+    const int *b;
+    const int *e;
+    const int *begin() const { return b; }
+    const int *end() const { return e; }
+    bool isEmpty() const { return b == e; }
+};
+
+// Rede genérica: matrizes QVector<QVector<...>> dimensionadas em runtime
+struct DynamicNetwork {
+    QVector<QVector<QVector<int>>> flightsByOrigDest;
+    QVector<QVector<int>> remaining;
+
+    void reset(int A)
+    {
+        flightsByOrigDest.resize(A);
+        for (int i = 0; i < A; ++i)
+            flightsByOrigDest[i].resize(A);
+        remaining = QVector<QVector<int>>(A, QVector<int>(A, 0));
+    }
+
+    // flights já vem ordenado por depMin: cada lista fica ordenada
+    void build(const QVector<FlightInstance> &flights)
+    {
+        for (int idx = 0; idx < flights.size(); ++idx) {
+            const FlightInstance &f = flights[idx];
+            flightsByOrigDest[f.orig][f.dest].append(idx);
+        }
+    }
+
+    IdxSpan legs(int o, int d) const
+    {
+        const QVector<int> &v = flightsByOrigDest[o][d];
+        return IdxSpan{v.constData(), v.constData() + v.size()};
+    }
+
+    int &demand(int o, int d) { return remaining[o][d]; }
+};
+
+// Rede de tamanho fixo (N aeroportos): sem indireção dupla nem alocação
+// por célula; os voos de cada par ficam contíguos num único vetor (CSR)
+template <int N>
+struct FixedNetwork {
+    std::array<int, N * N + 1>        offsets;
+    std::array<std::array<int, N>, N> remaining;
+    QVector<int>                      flat;
+
+    void reset(int /*A*/)
+    {
+        offsets.fill(0);
+        for (auto &row : remaining)
+            row.fill(0);
+    }
+
+    void build(const QVector<FlightInstance> &flights)
+    {
+        for (const FlightInstance &f : flights)
+            ++offsets[f.orig * N + f.dest + 1];
+        for (int c = 0; c < N * N; ++c)
+            offsets[c + 1] += offsets[c];
+
+        std::array<int, N * N> cursor;
+        std::copy(offsets.begin(), offsets.end() - 1, cursor.begin());
+        flat.resize(flights.size());
+        for (int idx = 0; idx < flights.size(); ++idx) {
+            const FlightInstance &f = flights[idx];
+            flat[cursor[f.orig * N + f.dest]++] = idx;
+        }
+    }
+
+    IdxSpan legs(int o, int d) const
+    {
+        const int c = o * N + d;
+        return IdxSpan{flat.constData() + offsets[c],
+                       flat.constData() + offsets[c + 1]};
+    }
+
+    int &demand(int o, int d) { return remaining[o][d]; }
+};
+
+} // namespace
+
+// Passos 3 e 4 do kernel: rede por par OD e alocação da demanda
+// (odDemand: diária, por par de m_data->od) nos voos já com aeronave.
+// Preenche usedSeats e as contagens de passageiros de stats
+template <class Net>
+void GAEngine::routePassengers(QVector<FlightInstance> &flights, const int *odDemand,
+                               EvalStats &stats, QVector<QVariantMap> *paxAssignments) const
+{
+    // 3) mapear voos por (orig,dest)
+    const int A = m_data->airports.size();
+    Net net;
+    net.reset(A);
+    net.build(flights);
+
+    // 4) atender demanda OD (direto ou 1 conexao); demanda diária x dias
+    for (int i = 0; i < m_data->od.size(); ++i)
+        net.demand(m_data->od[i].orig, m_data->od[i].dest) += odDemand[i] * m_data->params.numDays;
+
+    // aloca pax num itinerário e registra para o JSON final
+    auto assignPath = [&](int o, int dest, const QVector<int> &flightIdxs, int alloc) {
+        for (int fiIdx : flightIdxs) {
+            flights[fiIdx].usedSeats += alloc;
+        }
+
+        stats.servedTotal   += alloc;
+        if (flightIdxs.size() == 1)
+            stats.servedDirect += alloc;
+        else if (flightIdxs.size() == 2)
+            stats.servedOneHop += alloc;
+        else
+            stats.servedMultiHop += alloc;
+
+        int depFirst = flights[flightIdxs.first()].depMin;
+        int arrLast  = flights[flightIdxs.last()].arrMin;
+        int travel   = arrLast - depFirst;
+        stats.totalTravelTime += 1LL * travel * alloc;
+
+        if (!paxAssignments)
+            return;
+        QVariantMap rec;
+        rec["orig_id"]   = o;
+        rec["dest_id"]   = dest;
+        rec["pax"]       = alloc;
+        rec["num_legs"]  = flightIdxs.size();
+        rec["dep_min"]   = depFirst;
+        rec["arr_min"]   = arrLast;
+        rec["dep_hhmm"]  = formatTimeHHMM(depFirst);
+        rec["arr_hhmm"]  = formatTimeHHMM(arrLast);
+
+        QVariantList legs;
+        for (int fiIdx : flightIdxs) {
+            const FlightInstance &f = flights[fiIdx];
+            QVariantMap leg;
+            leg["flight_index"] = fiIdx; // vamos remapear depois do pruning
+            leg["route_id"]     = f.routeId;
+            leg["orig_id"]      = f.orig;
+            leg["dest_id"]      = f.dest;
+            leg["dep_min"]      = f.depMin;
+            leg["arr_min"]      = f.arrMin;
+            leg["dep_hhmm"]     = formatTimeHHMM(f.depMin);
+            leg["arr_hhmm"]     = formatTimeHHMM(f.arrMin);
+            leg["aircraft_idx"] = f.aircraftIdx;
+            legs.append(leg);
+        }
+        rec["legs"] = legs;
+
+        paxAssignments->append(rec);
+    };
+
+    auto pathCapacity = [&](const QVector<int> &flightIdxs) {
+        int pathCap = INT_MAX;
+        for (int fiIdx : flightIdxs) {
+            const FlightInstance &f = flights[fiIdx];
+            pathCap = qMin(pathCap, f.capacity - f.usedSeats);
+        }
+        return pathCap;
+    };
+
+    if (m_routingMode == RoutingMode::TimeExpanded) {
+        // aumentos sucessivos: itinerário mais rápido com assento livre,
+        // aloca o gargalo e repete até esgotar a demanda ou os caminhos
+        TimeExpandedRouter router(flights, A, m_data->params.minConnMin, m_maxLegs);
+        QVector<int> path;
+        for (const ODDemand &d : m_data->od) {
+            int o        = d.orig;
+            int dest     = d.dest;
+            int demandLeft = net.demand(o, dest);
+            while (demandLeft > 0 && router.findPath(o, dest, path)) {
+                int alloc = qMin(pathCapacity(path), demandLeft);
+                assignPath(o, dest, path, alloc);
+                demandLeft -= alloc;
+            }
+            net.demand(o, dest) = demandLeft;
+        }
+    } else {
+        // passagens por OD, para JSON final (modo guloso)
+        for (const ODDemand &d : m_data->od) {
+            int o        = d.orig;
+            int dest     = d.dest;
+            int demandLeft = net.demand(o, dest);
+            if (demandLeft <= 0) continue;
+
+            struct PathCand {
+                QVector<int> flightIdxs;
+                int travelMin;
+            };
+            QVector<PathCand> candidates;
+
+            // direto
+            for (int idx : net.legs(o, dest)) {
+                const FlightInstance &f = flights[idx];
+                int travel = f.arrMin - f.depMin;
+                PathCand c;
+                c.flightIdxs = {idx};
+                c.travelMin  = travel;
+                candidates.append(c);
+            }
+
+            // 1 conexao
+            for (int mid = 0; mid < A; ++mid) {
+                if (mid == o || mid == dest) continue;
+                const IdxSpan fo = net.legs(o, mid);
+                const IdxSpan fd = net.legs(mid, dest);
+                if (fo.isEmpty() || fd.isEmpty()) continue;
+
+                for (int idx1 : fo) {
+                    const FlightInstance &f1 = flights[idx1];
+                    for (int idx2 : fd) {
+                        const FlightInstance &f2 = flights[idx2];
+                        if (f1.arrMin + m_data->params.minConnMin > f2.depMin) continue;
+                        int travel = f2.arrMin - f1.depMin;
+                        PathCand c;
+                        c.flightIdxs = {idx1, idx2};
+                        c.travelMin  = travel;
+                        candidates.append(c);
+                    }
+                }
+            }
+
+            if (candidates.isEmpty())
+                continue;
+
+            std::sort(candidates.begin(), candidates.end(),
+                      [](const PathCand &a, const PathCand &b) {
+                          if (a.travelMin != b.travelMin)
+                              return a.travelMin < b.travelMin;
+                          return a.flightIdxs.size() < b.flightIdxs.size();
+                      });
+
+            // tenta usar vários caminhos em ordem de qualidade
+            for (const PathCand &pc : candidates) {
+                if (demandLeft <= 0) break;
+
+                int pathCap = pathCapacity(pc.flightIdxs);
+                if (pathCap <= 0) continue;
+
+                int alloc = qMin(pathCap, demandLeft);
+                assignPath(o, dest, pc.flightIdxs, alloc);
+                demandLeft -= alloc;
+            }
+
+            net.demand(o, dest) = demandLeft;
+        }
+    }
+
+    int unserved = 0;
+    for (int i = 0; i < A; ++i)
+        for (int j = 0; j < A; ++j)
+            unserved += net.demand(i, j);
+    stats.unserved = unserved;
+}
+
 // Avaliação de um cromossomo
 double GAEngine::evaluateChromosome(const QVector<bool> &chrom,
                                     EvalStats &stats,
                                     QVector<FlightInstance> &bestFlights,
-                                    QVector<QVariantMap> &paxAssignments) const
+                                    QVector<QVariantMap> &paxAssignments,
+                                    QVector<int> *droppedGenes) const
+{
+    const int numGenes = chrom.size();
+    if (numGenes != m_data->allFlights.size()) {
+        stats = EvalStats();
+        bestFlights.clear();
+        paxAssignments.clear();
+        return -1e9;
+    }
+
+    QVector<int> genes;
+    genes.reserve(numGenes / 16);
+    for (int g = 0; g < numGenes; ++g) {
+        if (chrom[g]) genes.append(g);
+    }
+    return evaluateGenes(genes.constData(), genes.size(),
+                         stats, bestFlights, paxAssignments, droppedGenes);
+}
+
+double GAEngine::evaluateChromosome(const QVector<int> &activeGenes,
+                                    EvalStats &stats,
+                                    QVector<FlightInstance> &bestFlights,
+                                    QVector<QVariantMap> &paxAssignments,
+                                    QVector<int> *droppedGenes) const
+{
+    if (!activeGenes.isEmpty()
+        && (activeGenes.first() < 0 || activeGenes.last() >= m_data->allFlights.size())) {
+        stats = EvalStats();
+        bestFlights.clear();
+        paxAssignments.clear();
+        return -1e9;
+    }
+    return evaluateGenes(activeGenes.constData(), activeGenes.size(),
+                         stats, bestFlights, paxAssignments, droppedGenes);
+}
+
+double GAEngine::evaluateGenes(const int *genes, int numActive,
+                               EvalStats &stats,
+                               QVector<FlightInstance> &bestFlights,
+                               QVector<QVariantMap> &paxAssignments,
+                               QVector<int> *droppedGenes) const
+{
+    GA_TRACE_SCOPE("evaluateChromosome", "eval");
+    double score;
+    if (m_useFixedKernel) {
+        score = evaluateKernel<FixedNetwork<GAConst::MaxFixedAirports>>(
+            genes, numActive, stats, bestFlights, paxAssignments, droppedGenes);
+    } else {
+        score = evaluateKernel<DynamicNetwork>(genes, numActive, stats, bestFlights,
+                                               paxAssignments, droppedGenes);
+    }
+    // objetivo robusto: a malha montada com a demanda nominal é pontuada
+    // pela média (ou quantil) das amostras de demanda
+    if (!m_demandSamples.isEmpty() && score > -1e9)
+        score = robustScore(bestFlights);
+    return score;
+}
+
+template <class Net>
+double GAEngine::evaluateKernel(const int *genes, int numActive,
+                                EvalStats &stats,
+                                QVector<FlightInstance> &bestFlights,
+                                QVector<QVariantMap> &paxAssignments,
+                                QVector<int> *droppedGenes,
+                                bool slotRetry) const
 {
     stats = EvalStats();
     bestFlights.clear();
     paxAssignments.clear();
+    const int droppedAtEntry = droppedGenes ? droppedGenes->size() : 0;
 
-    const int numGenes = chrom.size();
-    if (numGenes != m_allFlights.size())
-        return -1e9;
-
-    // 1) construir voos ativos
+    // 1) construir voos ativos (só os genes ligados; custo ~ voos ativos)
     QVector<FlightInstance> flights;
-    flights.reserve(numGenes);
-    for (int g = 0; g < numGenes; ++g) {
-        if (!chrom[g]) continue;
-        const FlightTemplate &ft = m_allFlights[g];
+    flights.reserve(numActive);
+    for (int k = 0; k < numActive; ++k) {
+        if (!m_geneBlocked.isEmpty() && m_geneBlocked[genes[k]]) {
+            if (droppedGenes) droppedGenes->append(genes[k]);
+            continue; // par proibido pela variação do cenário
+        }
+        const FlightTemplate &ft = m_data->allFlights[genes[k]];
         FlightInstance fi;
         fi.tmplId      = ft.id;
         fi.routeId     = ft.routeId;
@@ -251,7 +1826,8 @@ double GAEngine::evaluateChromosome(const QVector<bool> &chrom,
         fi.depMin      = ft.depMin;
         fi.arrMin      = ft.arrMin;
         fi.aircraftIdx = -1;
-        fi.capacity    = m_fleet.seatsPerAircraft;
+        fi.typeIdx     = ft.typeIdx;
+        fi.capacity    = m_data->fleet.types[ft.typeIdx].seats;
         fi.usedSeats   = 0;
         flights.append(fi);
     }
@@ -261,25 +1837,30 @@ double GAEngine::evaluateChromosome(const QVector<bool> &chrom,
 
     stats.numFlights = flights.size();
 
-    // 2) alocar aeronaves
-    struct AircraftState {
-        int airport;    // onde está (depois do primeiro voo)
-        int available;  // minuto a partir do qual pode decolar
-        int flightsUsed;
-        bool used;
-    };
-
-    const int DAY_START  = 6*60;
-    const int TURNAROUND = 60;
-
-    QVector<AircraftState> ac;
-    ac.resize(m_fleet.numAircraft);
-    for (int i = 0; i < m_fleet.numAircraft; ++i) {
-        ac[i].airport     = -1;       // sem base inicial
-        ac[i].available   = DAY_START;
-        ac[i].flightsUsed = 0;
-        ac[i].used        = false;
-    }
+    // 2) alocar aeronaves do tipo pedido por cada voo. Regra: aeronave
+    // ainda não usada do tipo (menor índice) se houver; senão a que está
+    // parada há mais tempo na origem e já cumpriu o turnaround. Índices por
+    // tipo: próxima aeronave livre e, por aeroporto, um heap mínimo de
+    // (disponível, índice) das aeronaves estacionadas lá
+    const int TURNAROUND = m_data->params.turnaroundMin;
+    const QVector<AircraftType> &types = m_data->fleet.types;
+    const int T  = types.size();
+    const int AP = m_data->airports.size();
+
+    QVarLengthArray<int, 8> nextFresh(T);
+    for (int t = 0; t < T; ++t)
+        nextFresh[t] = types[t].firstAircraft;
+    using Parked = std::pair<int, int>; // (disponível, índice)
+    std::vector<std::vector<Parked>> parked((size_t)T * AP);
+    const auto later = std::greater<Parked>();
+    const bool grounding = !m_acGroundedFrom.isEmpty();
+
+    // movimentos por slot com limite (slots.json), contados só para voos
+    // que recebem aeronave: por ordem de partida, o voo que estoura a
+    // capacidade é recusado antes de ocupar uma aeronave
+    const QVector<int> &slotCap = m_data->slotCapacity;
+    QVarLengthArray<int, 256> slotUse(slotCap.size());
+    std::fill(slotUse.begin(), slotUse.end(), 0);
 
     // ordenar voos por partida
     std::sort(flights.begin(), flights.end(),
@@ -288,34 +1869,54 @@ double GAEngine::evaluateChromosome(const QVector<bool> &chrom,
               });
 
     for (FlightInstance &f : flights) {
-        int bestAc   = -1;
-        int bestAvail = 1e9;
-
-        for (int i = 0; i < ac.size(); ++i) {
-            if (!ac[i].used) {
-                // primeira utilização define a base no voo
-                if (f.depMin >= ac[i].available && ac[i].available < bestAvail) {
-                    bestAc   = i;
-                    bestAvail = ac[i].available;
-                }
-            } else {
-                if (ac[i].airport != f.orig) continue;
-                if (ac[i].available + TURNAROUND > f.depMin) continue;
-                if (f.depMin >= ac[i].available && ac[i].available < bestAvail) {
-                    bestAc   = i;
-                    bestAvail = ac[i].available;
-                }
+        const AircraftType &type = types[f.typeIdx];
+        const int typeEnd = type.firstAircraft + type.count;
+        // aeronave parada a partir de um minuto (replanejamento): como os
+        // voos vêm em ordem de partida, sai dos índices de vez
+        if (grounding) {
+            while (nextFresh[f.typeIdx] < typeEnd
+                   && f.depMin >= m_acGroundedFrom[nextFresh[f.typeIdx]])
+                ++nextFresh[f.typeIdx];
+        }
+        const int ds = slotCap.isEmpty() ? -1 : m_data->geneDepSlot[f.tmplId];
+        const int as = slotCap.isEmpty() ? -1 : m_data->geneArrSlot[f.tmplId];
+        if ((ds >= 0 && slotUse[ds] >= slotCap[ds])
+            || (as >= 0 && slotUse[as] >= slotCap[as])) {
+            ++stats.slotRejected;
+            if (droppedGenes) droppedGenes->append(f.tmplId);
+            continue; // sem slot: fica sem aeronave
+        }
+
+        int acIdx = -1;
+        if (nextFresh[f.typeIdx] < typeEnd) {
+            acIdx = nextFresh[f.typeIdx]++;
+        } else if (f.orig >= 0 && f.orig < AP) {
+            std::vector<Parked> &heap = parked[(size_t)f.typeIdx * AP + f.orig];
+            while (grounding && !heap.empty()
+                   && f.depMin >= m_acGroundedFrom[heap.front().second]) {
+                std::pop_heap(heap.begin(), heap.end(), later);
+                heap.pop_back();
+            }
+            if (!heap.empty() && heap.front().first + TURNAROUND <= f.depMin) {
+                acIdx = heap.front().second;
+                std::pop_heap(heap.begin(), heap.end(), later);
+                heap.pop_back();
             }
         }
 
-        if (bestAc == -1)
+        if (acIdx == -1) {
+            if (droppedGenes) droppedGenes->append(f.tmplId);
             continue; // voo não realizado
+        }
 
-        f.aircraftIdx        = bestAc;
-        ac[bestAc].airport   = f.dest;
-        ac[bestAc].available = f.arrMin;
-        ac[bestAc].flightsUsed += 1;
-        ac[bestAc].used = true;
+        f.aircraftIdx = acIdx;
+        if (ds >= 0) ++slotUse[ds];
+        if (as >= 0) ++slotUse[as];
+        if (f.dest >= 0 && f.dest < AP) {
+            std::vector<Parked> &heap = parked[(size_t)f.typeIdx * AP + f.dest];
+            heap.emplace_back(f.arrMin, acIdx);
+            std::push_heap(heap.begin(), heap.end(), later);
+        }
     }
 
     // remover voos sem aeronave
@@ -341,154 +1942,8 @@ double GAEngine::evaluateChromosome(const QVector<bool> &chrom,
         stats.usedAircraft = usedAc.size();
     }
 
-    // 3) mapear voos por (orig,dest)
-    const int A = m_airports.size();
-    QVector<QVector<QVector<int>>> flightsByOrigDest;
-    flightsByOrigDest.resize(A);
-    for (int i = 0; i < A; ++i)
-        flightsByOrigDest[i].resize(A);
-
-    for (int idx = 0; idx < flights.size(); ++idx) {
-        const FlightInstance &f = flights[idx];
-        flightsByOrigDest[f.orig][f.dest].append(idx);
-    }
-
-    for (int i = 0; i < A; ++i)
-        for (int j = 0; j < A; ++j)
-            std::sort(flightsByOrigDest[i][j].begin(), flightsByOrigDest[i][j].end(),
-                      [&](int a, int b) {
-                          return flights[a].depMin < flights[b].depMin;
-                      });
-
-    // 4) atender demanda OD (direto ou 1 conexao)
-    int totalDemand = 0;
-    for (const ODDemand &d : m_od) totalDemand += d.demand;
-
-    QVector<QVector<int>> remaining(A, QVector<int>(A, 0));
-    for (const ODDemand &d : m_od)
-        remaining[d.orig][d.dest] += d.demand;
-
-    // passagens por OD, para JSON final
-    for (const ODDemand &d : m_od) {
-        int o        = d.orig;
-        int dest     = d.dest;
-        int demandLeft = remaining[o][dest];
-        if (demandLeft <= 0) continue;
-
-        struct PathCand {
-            QVector<int> flightIdxs;
-            int travelMin;
-        };
-        QVector<PathCand> candidates;
-
-        // direto
-        for (int idx : flightsByOrigDest[o][dest]) {
-            const FlightInstance &f = flights[idx];
-            int travel = f.arrMin - f.depMin;
-            PathCand c;
-            c.flightIdxs = {idx};
-            c.travelMin  = travel;
-            candidates.append(c);
-        }
-
-        // 1 conexao
-        for (int mid = 0; mid < A; ++mid) {
-            if (mid == o || mid == dest) continue;
-            const auto &fo = flightsByOrigDest[o][mid];
-            const auto &fd = flightsByOrigDest[mid][dest];
-            if (fo.isEmpty() || fd.isEmpty()) continue;
-
-            for (int idx1 : fo) {
-                const FlightInstance &f1 = flights[idx1];
-                for (int idx2 : fd) {
-                    const FlightInstance &f2 = flights[idx2];
-                    if (f1.arrMin + 60 > f2.depMin) continue;
-                    int travel = f2.arrMin - f1.depMin;
-                    PathCand c;
-                    c.flightIdxs = {idx1, idx2};
-                    c.travelMin  = travel;
-                    candidates.append(c);
-                }
-            }
-        }
-
-        if (candidates.isEmpty())
-            continue;
-
-        std::sort(candidates.begin(), candidates.end(),
-                  [](const PathCand &a, const PathCand &b) {
-                      if (a.travelMin != b.travelMin)
-                          return a.travelMin < b.travelMin;
-                      return a.flightIdxs.size() < b.flightIdxs.size();
-                  });
-
-        // tenta usar vários caminhos em ordem de qualidade
-        for (const PathCand &pc : candidates) {
-            if (demandLeft <= 0) break;
-
-            int pathCap = INT_MAX;
-            for (int fiIdx : pc.flightIdxs) {
-                const FlightInstance &f = flights[fiIdx];
-                pathCap = qMin(pathCap, f.capacity - f.usedSeats);
-            }
-            if (pathCap <= 0) continue;
-
-            int alloc = qMin(pathCap, demandLeft);
-
-            for (int fiIdx : pc.flightIdxs) {
-                flights[fiIdx].usedSeats += alloc;
-            }
-
-            demandLeft          -= alloc;
-            stats.servedTotal   += alloc;
-            if (pc.flightIdxs.size() == 1)
-                stats.servedDirect += alloc;
-            else
-                stats.servedOneHop += alloc;
-
-            int depFirst = flights[pc.flightIdxs.first()].depMin;
-            int arrLast  = flights[pc.flightIdxs.last()].arrMin;
-            int travel   = arrLast - depFirst;
-            stats.totalTravelTime += 1LL * travel * alloc;
-
-            QVariantMap rec;
-            rec["orig_id"]   = o;
-            rec["dest_id"]   = dest;
-            rec["pax"]       = alloc;
-            rec["num_legs"]  = pc.flightIdxs.size();
-            rec["dep_min"]   = depFirst;
-            rec["arr_min"]   = arrLast;
-            rec["dep_hhmm"]  = formatTimeHHMM(depFirst);
-            rec["arr_hhmm"]  = formatTimeHHMM(arrLast);
-
-            QVariantList legs;
-            for (int fiIdx : pc.flightIdxs) {
-                const FlightInstance &f = flights[fiIdx];
-                QVariantMap leg;
-                leg["flight_index"] = fiIdx; // vamos remapear depois do pruning
-                leg["route_id"]     = f.routeId;
-                leg["orig_id"]      = f.orig;
-                leg["dest_id"]      = f.dest;
-                leg["dep_min"]      = f.depMin;
-                leg["arr_min"]      = f.arrMin;
-                leg["dep_hhmm"]     = formatTimeHHMM(f.depMin);
-                leg["arr_hhmm"]     = formatTimeHHMM(f.arrMin);
-                leg["aircraft_idx"] = f.aircraftIdx;
-                legs.append(leg);
-            }
-            rec["legs"] = legs;
-
-            paxAssignments.append(rec);
-        }
-
-        remaining[o][dest] = demandLeft;
-    }
-
-    int unserved = 0;
-    for (int i = 0; i < A; ++i)
-        for (int j = 0; j < A; ++j)
-            unserved += remaining[i][j];
-    stats.unserved = unserved;
+    // 3-4) rotear os passageiros sobre os voos com aeronave
+    routePassengers<Net>(flights, m_odDemand.constData(), stats, &paxAssignments);
 
     // ------------------------------------------------------------------
     // 4.5) PRUNING: remove prefixo/sufixo de voos vazios por aeronave
@@ -496,10 +1951,10 @@ double GAEngine::evaluateChromosome(const QVector<bool> &chrom,
     if (flights.isEmpty())
         return -1e9;
 
-    QVector<QVector<int>> flightsPerAc(m_fleet.numAircraft);
+    QVector<QVector<int>> flightsPerAc(m_data->fleet.numAircraft);
     for (int idx = 0; idx < flights.size(); ++idx) {
         const FlightInstance &f = flights[idx];
-        if (f.aircraftIdx >= 0 && f.aircraftIdx < m_fleet.numAircraft) {
+        if (f.aircraftIdx >= 0 && f.aircraftIdx < m_data->fleet.numAircraft) {
             flightsPerAc[f.aircraftIdx].append(idx);
         }
     }
@@ -537,12 +1992,43 @@ double GAEngine::evaluateChromosome(const QVector<bool> &chrom,
     QVector<int> mapOldToNew(flights.size(), -1);
     QVector<FlightInstance> pruned;
     pruned.reserve(flights.size());
+    bool prunedSlot = false;
     for (int i = 0; i < flights.size(); ++i) {
-        if (!keep[i]) continue;
+        if (!keep[i]) {
+            if (droppedGenes) droppedGenes->append(flights[i].tmplId);
+            if (!slotCap.isEmpty())
+                prunedSlot = prunedSlot || m_data->geneDepSlot[flights[i].tmplId] >= 0
+                                        || m_data->geneArrSlot[flights[i].tmplId] >= 0;
+            continue;
+        }
         mapOldToNew[i] = pruned.size();
         pruned.append(flights[i]);
     }
 
+    // voos podados liberam o slot: se algum voo foi recusado por slot,
+    // reavalia uma vez sem os genes podados (estavam vazios), para que o
+    // recusado possa ocupar o lugar
+    if (slotRetry && prunedSlot && stats.slotRejected > 0) {
+        QVarLengthArray<char, 256> gone(m_data->allFlights.size());
+        std::fill(gone.begin(), gone.end(), 0);
+        for (int i = 0; i < flights.size(); ++i)
+            if (!keep[i])
+                gone[flights[i].tmplId] = 1;
+        QVector<int> retryGenes;
+        retryGenes.reserve(numActive);
+        for (int k = 0; k < numActive; ++k)
+            if (!gone[genes[k]])
+                retryGenes.append(genes[k]);
+        if (droppedGenes) {
+            droppedGenes->resize(droppedAtEntry);
+            for (int i = 0; i < flights.size(); ++i)
+                if (!keep[i])
+                    droppedGenes->append(flights[i].tmplId);
+        }
+        return evaluateKernel<Net>(retryGenes.constData(), retryGenes.size(), stats,
+                                   bestFlights, paxAssignments, droppedGenes, false);
+    }
+
     flights.swap(pruned);
 
     if (flights.isEmpty())
@@ -578,6 +2064,14 @@ double GAEngine::evaluateChromosome(const QVector<bool> &chrom,
     // ------------------------------------------------------------------
     // 5) calcula fitness (já com voos podados)
     // ------------------------------------------------------------------
+    const double score = scoreFlights(stats, flights);
+
+    bestFlights = flights; // copia voos finais usados (já podados)
+    return score;
+}
+
+double GAEngine::scoreFlights(const EvalStats &stats, const QVector<FlightInstance> &flights) const
+{
     double score = 0.0;
 
     score += 100000.0 * stats.servedTotal;
@@ -587,11 +2081,11 @@ double GAEngine::evaluateChromosome(const QVector<bool> &chrom,
     score -= 50000.0 * (double)stats.unserved;
 
     // limitar voos e aeronaves
-    if (stats.numFlights > 1000) {
-        score -= 100000.0 * (stats.numFlights - 1000);
+    if (stats.numFlights > GAConst::MaxFlights) {
+        score -= 100000.0 * (stats.numFlights - GAConst::MaxFlights);
     }
-    if (stats.usedAircraft > m_fleet.numAircraft) {
-        score -= 100000.0 * (stats.usedAircraft - m_fleet.numAircraft);
+    if (stats.usedAircraft > m_data->fleet.numAircraft) {
+        score -= 100000.0 * (stats.usedAircraft - m_data->fleet.numAircraft);
     }
 
     // penalização leve pra voos vazios REMANESCENTES (no meio)
@@ -601,184 +2095,702 @@ double GAEngine::evaluateChromosome(const QVector<bool> &chrom,
     }
     score -= 1000.0 * (double)emptyFlights;
 
-    bestFlights = flights; // copia voos finais usados (já podados)
     return score;
 }
 
+double GAEngine::evaluateRouting(const QVector<FlightInstance> &flights, const int *odDemand,
+                                 EvalStats &stats) const
+{
+    thread_local QVector<FlightInstance> work;
+    stats = EvalStats();
+    work = flights;
+    for (FlightInstance &f : work)
+        f.usedSeats = 0;
+    if (work.isEmpty()) {
+        // malha vazia: toda a demanda fica sem atendimento
+        for (int i = 0; i < m_data->od.size(); ++i)
+            stats.unserved += odDemand[i] * m_data->params.numDays;
+        return scoreFlights(stats, work);
+    }
+
+    if (m_useFixedKernel)
+        routePassengers<FixedNetwork<GAConst::MaxFixedAirports>>(work, odDemand, stats, nullptr);
+    else
+        routePassengers<DynamicNetwork>(work, odDemand, stats, nullptr);
+
+    // malha fixa: sem pruning, voos vazios continuam voando
+    QSet<int> usedAc;
+    for (const FlightInstance &f : work)
+        usedAc.insert(f.aircraftIdx);
+    stats.numFlights   = work.size();
+    stats.usedAircraft = usedAc.size();
+    return scoreFlights(stats, work);
+}
+
+double GAEngine::robustScore(const QVector<FlightInstance> &flights) const
+{
+    thread_local QVector<double> sampleScores;
+    sampleScores.resize(m_demandSamples.size());
+    EvalStats s;
+    for (int k = 0; k < m_demandSamples.size(); ++k)
+        sampleScores[k] = evaluateRouting(flights, m_demandSamples[k].constData(), s);
+    if (m_robustQuantile < 0.0)
+        return std::accumulate(sampleScores.constBegin(), sampleScores.constEnd(), 0.0)
+               / sampleScores.size();
+    const int k = qBound(0, int(m_robustQuantile * (sampleScores.size() - 1)),
+                         sampleScores.size() - 1);
+    std::nth_element(sampleScores.begin(), sampleScores.begin() + k, sampleScores.end());
+    return sampleScores[k];
+}
+
+void GAEngine::setRobustObjective(const QVector<QVector<int>> &demandSamples, double quantile)
+{
+    m_demandSamples = demandSamples;
+    m_robustQuantile = quantile;
+}
+
+bool GAEngine::sparseChromosomes() const
+{
+    switch (m_chromMode) {
+    case ChromosomeMode::Dense:  return false;
+    case ChromosomeMode::Sparse: return true;
+    case ChromosomeMode::Auto:   break;
+    }
+    return m_data->allFlights.size() >= GAConst::SparseAutoGenes;
+}
+
 GAResult GAEngine::runGA(int population, int generations,
                          ProgressCallback cbProgress)
+{
+    if (m_multiObjective) {
+        if (sparseChromosomes())
+            return runNSGA2Impl<QVector<int>>(population, generations, cbProgress);
+        return runNSGA2Impl<QVector<bool>>(population, generations, cbProgress);
+    }
+    if (sparseChromosomes())
+        return runGAImpl<QVector<int>>(population, generations, cbProgress);
+    return runGAImpl<QVector<bool>>(population, generations, cbProgress);
+}
+
+template <class Chrom>
+GAResult GAEngine::runGAImpl(int population, int generations,
+                             ProgressCallback cbProgress)
 {
     GAResult result;
-    if (m_allFlights.isEmpty() || m_routes.isEmpty() || m_od.isEmpty()) {
+    if (m_data->allFlights.isEmpty() || m_data->routes.isEmpty() || m_data->od.isEmpty()) {
         result.summaryText = "Missing data (routes / flights / passengers).";
         return result;
     }
 
-    const int numGenes = m_allFlights.size();
-
-    QVector<QVector<bool>> pop = initPopulation(population, numGenes);
+    QVector<Chrom> pop;
+    initPopulation(pop, population);
     QVector<double> scores(population, -1e9);
     QJsonArray gaHistory;
     QElapsedTimer timer;
+    QElapsedTimer runTimer;
+    runTimer.start();
 
     double bestScore = -1e9;
-    QVector<bool> bestInd;
+    Chrom bestInd;
     EvalStats bestStats;
     QVector<FlightInstance> bestFlights;
     QVector<QVariantMap> bestPaxAssignments;
 
-    // população inicial
-    timer.start();
-    double bestGenScore = -1e9;
-    double worstGenScore = 1e9;
-    double sumScores = 0.0;
-    EvalStats bestGenStats;
+    // reparo lamarckiano: genes descartados pela avaliação são removidos
+    QVector<int> dropped;
+
+    // pré-triagem: filhos rejeitados não são avaliados (exceto uma amostra
+    // de auditoria) e ficam com o pior score avaliado da geração, para não
+    // vencerem torneio nem ocupar vaga de elite com uma estimativa otimista
+    const bool screening = (m_screening != ScreeningMode::Off);
+    QVector<char> screenedOut(population, 0);
+    QVector<double> scoresSorted(population);
+    double screenThreshold = -1e18;
+    QRandomGenerator *rng = &m_rng;
+
+    // mutação adaptativa: taxa corrente e imigrantes desta geração
+    double pMutNow = m_gaParams.pMut;
+    int immigrants = 0;
+    PopDiversity diversity;
+
+    // avalia a população atual e registra a geração no histórico
+    auto evaluateGeneration = [&](int gen, qint64 breedUs) {
+        GA_TRACE_SCOPE("evaluateGeneration", "ga", gen);
+        timer.start();
+        double bestGenScore = -1e9;
+        double worstGenScore = 1e9;
+        double sumScores = 0.0;
+        int evaluated = 0;
+        EvalStats bestGenStats;
+        long long repairedGenes = 0;
+        long long activeGenes   = 0;
+        int screenRejected = 0;
+        int screenAudited  = 0;
+        int screenCorrect  = 0;
 
-    for (int i = 0; i < population; ++i) {
-        EvalStats s;
-        QVector<FlightInstance> flightsTmp;
-        QVector<QVariantMap> paxTmp;
-        double sc = evaluateChromosome(pop[i], s, flightsTmp, paxTmp);
-        scores[i] = sc;
-        sumScores += sc;
-        if (sc > bestGenScore) {
-            bestGenScore = sc;
-            bestGenStats = s;
+        for (int i = 0; i < population; ++i) {
+            const bool audit = screenedOut[i]
+                               && rng->generateDouble() < GAConst::ScreenAuditRate;
+            if (screenedOut[i]) {
+                ++screenRejected;
+                if (!audit)
+                    continue;
+                screenedOut[i] = 0; // auditado: tem score real
+            }
+
+            EvalStats s;
+            QVector<FlightInstance> flightsTmp;
+            QVector<QVariantMap> paxTmp;
+            dropped.clear();
+            double sc = evaluateChromosome(pop[i], s, flightsTmp, paxTmp,
+                                           m_repair ? &dropped : nullptr);
+            if (m_repair) {
+                activeGenes   += activeCount(pop[i]);
+                repairedGenes += dropped.size();
+                removeGenes(pop[i], dropped);
+            }
+            scores[i] = sc;
+            sumScores += sc;
+            ++evaluated;
+            if (audit) {
+                ++screenAudited;
+                if (sc < screenThreshold) ++screenCorrect;
+            }
+            if (sc > bestGenScore) {
+                bestGenScore = sc;
+                bestGenStats = s;
+            }
+            if (sc < worstGenScore) {
+                worstGenScore = sc;
+            }
+            if (sc > bestScore) {
+                bestScore          = sc;
+                copyChromosome(bestInd, pop[i]);
+                bestStats          = s;
+                bestFlights        = flightsTmp;
+                bestPaxAssignments = paxTmp;
+            }
         }
-        if (sc < worstGenScore) {
-            worstGenScore = sc;
+        // rejeitados: fora de avg/worst, com o pior score avaliado
+        if (screenRejected > screenAudited) {
+            for (int i = 0; i < population; ++i) {
+                if (screenedOut[i])
+                    scores[i] = worstGenScore;
+            }
         }
-        if (sc > bestScore) {
-            bestScore          = sc;
-            bestInd            = pop[i];
-            bestStats          = s;
-            bestFlights        = flightsTmp;
-            bestPaxAssignments = paxTmp;
+
+        {
+            GA_TRACE_SCOPE("diversity", "ga", gen);
+            diversity = measureDiversity(pop, gen);
         }
-    }
 
-    {
         qint64 durationMs = timer.elapsed();
-        double avgScore = (population > 0) ? (sumScores / (double)population) : 0.0;
+        double avgScore = (evaluated > 0) ? (sumScores / (double)evaluated) : 0.0;
         QJsonObject genObj;
-        genObj["generation"]      = 0;
+        genObj["generation"]      = gen;
         genObj["best_score"]      = bestGenScore;
         genObj["avg_score"]       = avgScore;
         genObj["worst_score"]     = worstGenScore;
         genObj["served_total"]    = bestGenStats.servedTotal;
         genObj["served_direct"]   = bestGenStats.servedDirect;
         genObj["served_1hop"]     = bestGenStats.servedOneHop;
+        genObj["served_multihop"] = bestGenStats.servedMultiHop;
         genObj["unserved"]        = bestGenStats.unserved;
         genObj["num_flights"]     = bestGenStats.numFlights;
         genObj["used_aircraft"]   = bestGenStats.usedAircraft;
         genObj["duration_ms"]     = (double)durationMs;
+        genObj["gap"]             = optimalityGap(bestScore);
+        if (gen > 0)
+            genObj["breed_ms"]    = breedUs / 1000.0;
+        if (m_repair) {
+            genObj["repaired_genes"] = (double)repairedGenes;
+            genObj["repair_rate"]    = activeGenes > 0 ? (double)repairedGenes / activeGenes : 0.0;
+        }
+        genObj["diversity_hamming"]  = diversity.hamming;
+        genObj["diversity_relative"] = diversity.relative;
+        genObj["gene_entropy"]       = diversity.entropy;
+        genObj["duplicate_rate"]     = diversity.duplicate;
+        if (m_adaptiveMutation) {
+            genObj["p_mut"]          = pMutNow;
+            genObj["immigrants"]     = immigrants;
+        }
+        if (screening && gen > 0) {
+            genObj["screen_rejected"]   = screenRejected;
+            genObj["evals_saved"]       = screenRejected - screenAudited;
+            genObj["screen_audited"]    = screenAudited;
+            genObj["screen_accuracy"]   = screenAudited > 0
+                                            ? (double)screenCorrect / screenAudited : 1.0;
+        }
         gaHistory.append(genObj);
-    }
+
+        if (m_metrics)
+            m_metrics->generationDone(gen, bestScore, avgScore, evaluated,
+                                      breedUs, timer.nsecsElapsed() / 1000);
+    };
+
+    if (m_metrics) m_metrics->runStarted(population, generations);
+
+    // população inicial
+    evaluateGeneration(0, 0);
 
     if (cbProgress) cbProgress(0, bestScore);
 
-    QRandomGenerator *rng = QRandomGenerator::global();
+    const double pCross  = m_gaParams.pCross;
+    const double pMut    = m_gaParams.pMut;
+    const int tourSize   = m_gaParams.tournamentSize;
+    const int eliteCount = qBound(1, (int)(population * m_gaParams.eliteFrac), population);
 
     auto tournament = [&](const QVector<double> &scores) -> int {
-        int a = rng->bounded(population);
-        int b = rng->bounded(population);
-        return (scores[a] > scores[b]) ? a : b;
+        int best = rng->bounded(population);
+        for (int t = 1; t < tourSize; ++t) {
+            const int c = rng->bounded(population);
+            if (scores[c] > scores[best]) best = c;
+        }
+        return best;
     };
 
-    const double pCross    = 0.8;
-    const double pMut      = 0.01;
-    const double eliteFrac = 0.1;
-    const int eliteCount   = qMax(1, (int)(population * eliteFrac));
+    // diversidade colapsada (pares quase iguais ou muitos repetidos): pMut
+    // sobe 1.5x por geração até o teto; recuperada, volta 1.5x por geração
+    // até a taxa base. Colapso sem melhora por AdaptiveStallGens gerações
+    // troca os piores filhos da próxima geração (pela estimativa de
+    // screenEstimate, já que ainda não foram avaliados) por imigrantes
+    int stallGens = 0;
+    double lastBest = bestScore;
+    bool injectImmigrants = false;
+    auto adaptMutation = [&]() {
+        const bool collapsed = diversity.relative < GAConst::DiversityCollapse
+                               || diversity.duplicate > GAConst::DuplicateCollapse;
+        pMutNow = collapsed ? qMin(pMut * GAConst::AdaptiveMaxMutFactor, pMutNow * 1.5)
+                            : qMax(pMut, pMutNow / 1.5);
+        stallGens = (bestScore > lastBest) ? 0 : stallGens + 1;
+        lastBest = bestScore;
+        injectImmigrants = collapsed && stallGens >= GAConst::AdaptiveStallGens;
+        if (injectImmigrants)
+            stallGens = 0;
+    };
+    if (m_adaptiveMutation)
+        adaptMutation();
+
+    // dois buffers de população que alternam de papel a cada geração,
+    // pré-alocados com o tamanho de um indivíduo; no modo denso nenhum
+    // indivíduo é alocado depois daqui
+    QVector<Chrom> next(population);
+    for (Chrom &ind : next)
+        copyChromosome(ind, pop[0]);
+    Chrom spare; // segundo filho quando a população é ímpar
+    copyChromosome(spare, pop[0]);
+    QVector<int> idxs(population);
+    QElapsedTimer breedTimer;
 
     for (int gen = 1; gen <= generations; ++gen) {
-        QVector<QVector<bool>> newPop;
-        newPop.reserve(population);
+        GA_TRACE_SCOPE("generation", "ga", gen);
+        breedTimer.start();
 
-        QVector<int> idxs(population);
-        for (int i = 0; i < population; ++i) idxs[i] = i;
-        std::sort(idxs.begin(), idxs.end(), [&](int a, int b){
-            return scores[a] > scores[b];
-        });
-        for (int i = 0; i < eliteCount; ++i) {
-            newPop.append(pop[idxs[i]]);
+        {
+            GA_TRACE_SCOPE("breed", "ga", gen);
+            // elite: só precisa dos eliteCount melhores, sem ordenar o resto
+            std::iota(idxs.begin(), idxs.end(), 0);
+            std::nth_element(idxs.begin(), idxs.begin() + (eliteCount - 1), idxs.end(),
+                             [&](int a, int b) { return scores[a] > scores[b]; });
+            for (int i = 0; i < eliteCount; ++i)
+                copyChromosome(next[i], pop[idxs[i]]);
+
+            // limiar da pré-triagem: mediana dos scores da geração dos pais
+            if (screening) {
+                std::copy(scores.constBegin(), scores.constEnd(), scoresSorted.begin());
+                const int mid = population / 2;
+                std::nth_element(scoresSorted.begin(), scoresSorted.begin() + mid,
+                                 scoresSorted.end());
+                screenThreshold = scoresSorted[mid];
+                std::fill(screenedOut.begin(), screenedOut.end(), 0);
+            }
+            auto screenChild = [&](int k) {
+                if (screenEstimate(next[k]) < screenThreshold)
+                    screenedOut[k] = 1;
+            };
+
+            for (int k = eliteCount; k < population; k += 2) {
+                int i1 = tournament(scores);
+                int i2 = tournament(scores);
+                Chrom &c1 = next[k];
+                Chrom &c2 = (k + 1 < population) ? next[k + 1] : spare;
+                crossover(pop[i1], pop[i2], c1, c2, pCross);
+                mutate(c1, pMutNow);
+                mutate(c2, pMutNow);
+                if (screening) {
+                    screenChild(k);
+                    if (k + 1 < population) screenChild(k + 1);
+                }
+            }
+
+            // imigrantes no lugar dos filhos de menor estimativa (nunca a
+            // elite), com a densidade do melhor indivíduo
+            immigrants = 0;
+            // só elite (eliteFrac 1.0 ou população 1): não há filho a trocar
+            const int immigrantCount = qMin(population - eliteCount,
+                                            qMax(1, int(population * GAConst::ImmigrantFrac)));
+            if (injectImmigrants && immigrantCount > 0) {
+                const int count = immigrantCount;
+                const double density = (double)activeCount(bestInd) / qMax(1, numGenes());
+                QVector<double> estimate(population);
+                for (int k = eliteCount; k < population; ++k)
+                    estimate[k] = screenEstimate(next[k]);
+                std::iota(idxs.begin(), idxs.end(), 0);
+                std::nth_element(idxs.begin() + eliteCount, idxs.begin() + eliteCount + (count - 1),
+                                 idxs.end(),
+                                 [&](int a, int b) { return estimate[a] < estimate[b]; });
+                for (int i = eliteCount; i < eliteCount + count; ++i) {
+                    immigrant(next[idxs[i]], density);
+                    screenedOut[idxs[i]] = 0;
+                }
+                immigrants = count;
+            }
+        }
+        pop.swap(next);
+        evaluateGeneration(gen, breedTimer.nsecsElapsed() / 1000);
+        if (m_adaptiveMutation)
+            adaptMutation();
+
+        if (cbProgress) cbProgress(gen, bestScore);
+
+        if (m_gapStop > 0.0 && optimalityGap(bestScore) <= m_gapStop)
+            break; // perto o bastante do limite superior
+        if (m_timeBudgetMs > 0 && runTimer.elapsed() >= m_timeBudgetMs)
+            break; // orçamento de tempo (replanejamento)
+        if (m_stopFlag && m_stopFlag->load(std::memory_order_relaxed))
+            break; // cancelado (--serve)
+    }
+
+    if (m_metrics) m_metrics->runFinished();
+
+    result = buildResult(bestScore, bestStats, bestFlights, bestPaxAssignments, gaHistory);
+    collectTopSchedules(pop, scores, result);
+    return result;
+}
+
+template <class Chrom>
+void GAEngine::collectTopSchedules(const QVector<Chrom> &pop, const QVector<double> &scores,
+                                   GAResult &result) const
+{
+    if (m_keepTop <= 0)
+        return;
+    QVector<int> order(pop.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(),
+              [&](int a, int b) { return scores[a] > scores[b]; });
+
+    // população convergida tem cópias: pula cromossomos já escolhidos
+    QVector<int> chosen;
+    for (int i : order) {
+        if (chosen.size() >= m_keepTop)
+            break;
+        bool dup = false;
+        for (int c : chosen)
+            dup = dup || pop[c] == pop[i];
+        if (dup)
+            continue;
+        EvalStats s;
+        QVector<FlightInstance> flightsTmp;
+        QVector<QVariantMap> paxTmp;
+        const double sc = evaluateChromosome(pop[i], s, flightsTmp, paxTmp);
+        if (sc <= -1e9)
+            continue;
+        chosen.append(i);
+        result.topScores.append(sc);
+        result.topFlights.append(flightsTmp);
+    }
+}
+
+// NSGA-II (mu + lambda): filhos por torneio binário em (frente, crowding),
+// seleção dos N melhores da união pais + filhos por frentes não-dominadas
+// e, na última frente que cabe, por maior distância de crowding
+template <class Chrom>
+GAResult GAEngine::runNSGA2Impl(int population, int generations,
+                                ProgressCallback cbProgress)
+{
+    GAResult result;
+    if (m_data->allFlights.isEmpty() || m_data->routes.isEmpty() || m_data->od.isEmpty()) {
+        result.summaryText = "Missing data (routes / flights / passengers).";
+        return result;
+    }
+    population = qMax(2, population);
+    const int N = population;
+
+    QVector<Chrom> pop;
+    initPopulation(pop, N);
+    QVector<Chrom> off(N);
+    for (Chrom &ind : off)
+        copyChromosome(ind, pop[0]);
+    QVector<Chrom> nextPop(N);
+    for (Chrom &ind : nextPop)
+        copyChromosome(ind, pop[0]);
+    Chrom spare;
+    copyChromosome(spare, pop[0]);
+
+    // posições 0..N-1: população atual; N..2N-1: filhos
+    QVector<MOPoint> pts(2 * N);
+    QVector<double> scores(2 * N, -1e9);
+    QVector<EvalStats> stats(2 * N);
+    QVector<int> rank(2 * N, 0);
+    QVector<double> crowd(2 * N, 0.0);
+    QVector<QVector<int>> fronts;
+
+    QJsonArray gaHistory;
+    QElapsedTimer timer;
+    QElapsedTimer runTimer;
+    runTimer.start();
+    double bestScore = -1e9;
+    Chrom bestInd;
+    EvalStats bestStats;
+    QVector<FlightInstance> bestFlights;
+    QVector<QVariantMap> bestPaxAssignments;
+    QVector<int> dropped;
+    QRandomGenerator *rng = &m_rng;
+
+    auto evaluateInto = [&](Chrom &ind, int slot) {
+        EvalStats s;
+        QVector<FlightInstance> flightsTmp;
+        QVector<QVariantMap> paxTmp;
+        dropped.clear();
+        const double sc = evaluateChromosome(ind, s, flightsTmp, paxTmp,
+                                             m_repair ? &dropped : nullptr);
+        if (m_repair)
+            removeGenes(ind, dropped);
+        MOPoint &p = pts[slot];
+        p.f[0] = -(double)s.servedTotal;
+        p.f[1] = (double)s.totalTravelTime;
+        p.f[2] = (double)s.usedAircraft;
+        p.viol = qMax(0, s.numFlights - GAConst::MaxFlights);
+        scores[slot] = sc;
+        stats[slot]  = s;
+        if (sc > bestScore) {
+            bestScore          = sc;
+            copyChromosome(bestInd, ind);
+            bestStats          = s;
+            bestFlights        = flightsTmp;
+            bestPaxAssignments = paxTmp;
         }
+    };
 
-        while (newPop.size() < population) {
-            int i1 = tournament(scores);
-            int i2 = tournament(scores);
-            QVector<bool> c1, c2;
-            crossover(pop[i1], pop[i2], c1, c2, pCross);
-            mutate(c1, pMut);
-            mutate(c2, pMut);
-            newPop.append(c1);
-            if (newPop.size() < population)
-                newPop.append(c2);
+    auto recordGeneration = [&](int gen, qint64 breedUs) {
+        const qint64 evalUs = timer.nsecsElapsed() / 1000;
+        const qint64 durationMs = (breedUs + evalUs) / 1000;
+        int bestIdx = 0;
+        double sumScores = 0.0;
+        double worst = 1e18;
+        for (int i = 0; i < N; ++i) {
+            sumScores += scores[i];
+            worst = qMin(worst, scores[i]);
+            if (scores[i] > scores[bestIdx]) bestIdx = i;
         }
+        int frontSize = 0;
+        double servedMax = 0.0;
+        double ttMin = std::numeric_limits<double>::max();
+        double acMin = std::numeric_limits<double>::max();
+        for (int i = 0; i < N; ++i) {
+            if (rank[i] != 0) continue;
+            ++frontSize;
+            servedMax = qMax(servedMax, -pts[i].f[0]);
+            ttMin     = qMin(ttMin, pts[i].f[1]);
+            acMin     = qMin(acMin, pts[i].f[2]);
+        }
+        const EvalStats &bs = stats[bestIdx];
+        QJsonObject genObj;
+        genObj["generation"]        = gen;
+        genObj["best_score"]        = scores[bestIdx];
+        genObj["avg_score"]         = sumScores / N;
+        genObj["worst_score"]       = worst;
+        genObj["served_total"]      = bs.servedTotal;
+        genObj["served_direct"]     = bs.servedDirect;
+        genObj["served_1hop"]       = bs.servedOneHop;
+        genObj["served_multihop"]   = bs.servedMultiHop;
+        genObj["unserved"]          = bs.unserved;
+        genObj["num_flights"]       = bs.numFlights;
+        genObj["used_aircraft"]     = bs.usedAircraft;
+        genObj["duration_ms"]       = (double)durationMs;
+        genObj["gap"]               = optimalityGap(bestScore);
+        genObj["front_size"]        = frontSize;
+        genObj["num_fronts"]        = fronts.size();
+        genObj["front_served_max"]  = servedMax;
+        genObj["front_tt_min"]      = ttMin;
+        genObj["front_aircraft_min"] = acMin;
+        const PopDiversity div = measureDiversity(pop, gen);
+        genObj["diversity_hamming"]  = div.hamming;
+        genObj["diversity_relative"] = div.relative;
+        genObj["gene_entropy"]       = div.entropy;
+        genObj["duplicate_rate"]     = div.duplicate;
+        gaHistory.append(genObj);
 
-        pop.swap(newPop);
+        if (m_metrics)
+            m_metrics->generationDone(gen, bestScore, sumScores / N, N, breedUs, evalUs);
+    };
 
-        timer.restart();
-        double bestGenScoreG = -1e9;
-        double worstGenScoreG = 1e9;
-        double sumScoresG = 0.0;
-        EvalStats bestGenStatsG;
+    QVector<int> popIds(N);
+    std::iota(popIds.begin(), popIds.end(), 0);
+    QVector<int> allIds(2 * N);
+    std::iota(allIds.begin(), allIds.end(), 0);
 
-        for (int i = 0; i < population; ++i) {
-            EvalStats s;
-            QVector<FlightInstance> flightsTmp;
-            QVector<QVariantMap> paxTmp;
-            double sc = evaluateChromosome(pop[i], s, flightsTmp, paxTmp);
-            scores[i] = sc;
-            sumScoresG += sc;
-            if (sc > bestGenScoreG) {
-                bestGenScoreG = sc;
-                bestGenStatsG = s;
-            }
-            if (sc < worstGenScoreG) {
-                worstGenScoreG = sc;
-            }
-            if (sc > bestScore) {
-                bestScore          = sc;
-                bestInd            = pop[i];
-                bestStats          = s;
-                bestFlights        = flightsTmp;
-                bestPaxAssignments = paxTmp;
-            }
+    if (m_metrics) m_metrics->runStarted(N, generations);
+
+    timer.start();
+    for (int i = 0; i < N; ++i)
+        evaluateInto(pop[i], i);
+    nonDominatedSort(pts, popIds, rank, fronts);
+    for (const QVector<int> &F : fronts)
+        crowdingDistance(pts, F, crowd);
+    recordGeneration(0, 0);
+    if (cbProgress) cbProgress(0, bestScore);
+
+    const double pCross = m_gaParams.pCross;
+    const double pMut   = m_gaParams.pMut;
+    const int tourSize  = m_gaParams.tournamentSize;
+
+    auto tournament = [&]() -> int {
+        int best = rng->bounded(N);
+        for (int t = 1; t < tourSize; ++t) {
+            const int c = rng->bounded(N);
+            if (rank[c] < rank[best] || (rank[c] == rank[best] && crowd[c] > crowd[best]))
+                best = c;
         }
+        return best;
+    };
+    QVector<int> selected;
+    selected.reserve(N);
+    QVector<MOPoint> ptsTmp(N);
+    QVector<double> scoresTmp(N);
+    QVector<EvalStats> statsTmp(N);
+    QVector<int> rankTmp(N);
+    QVector<double> crowdTmp(N);
+
+    for (int gen = 1; gen <= generations; ++gen) {
+        GA_TRACE_SCOPE("generation", "ga", gen);
+        timer.start();
 
         {
-            qint64 durationMs = timer.elapsed();
-            double avgScore = (population > 0) ? (sumScoresG / (double)population) : 0.0;
-            QJsonObject genObj;
-            genObj["generation"]      = gen;
-            genObj["best_score"]      = bestGenScoreG;
-            genObj["avg_score"]       = avgScore;
-            genObj["worst_score"]     = worstGenScoreG;
-            genObj["served_total"]    = bestGenStatsG.servedTotal;
-            genObj["served_direct"]   = bestGenStatsG.servedDirect;
-            genObj["served_1hop"]     = bestGenStatsG.servedOneHop;
-            genObj["unserved"]        = bestGenStatsG.unserved;
-            genObj["num_flights"]     = bestGenStatsG.numFlights;
-            genObj["used_aircraft"]   = bestGenStatsG.usedAircraft;
-            genObj["duration_ms"]     = (double)durationMs;
-            gaHistory.append(genObj);
+            GA_TRACE_SCOPE("breed", "ga", gen);
+            for (int k = 0; k < N; k += 2) {
+                const int i1 = tournament();
+                const int i2 = tournament();
+                Chrom &c1 = off[k];
+                Chrom &c2 = (k + 1 < N) ? off[k + 1] : spare;
+                crossover(pop[i1], pop[i2], c1, c2, pCross);
+                mutate(c1, pMut);
+                mutate(c2, pMut);
+            }
+        }
+        const qint64 breedUs = timer.nsecsElapsed() / 1000;
+        timer.start();
+        {
+            GA_TRACE_SCOPE("evaluateGeneration", "ga", gen);
+            for (int k = 0; k < N; ++k)
+                evaluateInto(off[k], N + k);
+        }
+
+        // sobrevivência: frentes inteiras enquanto couberem
+        GA_TRACE_SCOPE("survival", "ga", gen);
+        nonDominatedSort(pts, allIds, rank, fronts);
+        selected.clear();
+        for (QVector<int> &F : fronts) {
+            crowdingDistance(pts, F, crowd);
+            if (selected.size() + F.size() <= N) {
+                for (int id : F) selected.append(id);
+                if (selected.size() == N) break;
+                continue;
+            }
+            const int need = N - selected.size();
+            std::partial_sort(F.begin(), F.begin() + need, F.end(),
+                              [&](int a, int b) { return crowd[a] > crowd[b]; });
+            for (int j = 0; j < need; ++j) selected.append(F[j]);
+            break;
         }
 
+        for (int i = 0; i < N; ++i) {
+            const int id = selected[i];
+            copyChromosome(nextPop[i], id < N ? pop[id] : off[id - N]);
+            ptsTmp[i]    = pts[id];
+            scoresTmp[i] = scores[id];
+            statsTmp[i]  = stats[id];
+            rankTmp[i]   = rank[id];
+            crowdTmp[i]  = crowd[id];
+        }
+        pop.swap(nextPop);
+        std::copy(ptsTmp.constBegin(), ptsTmp.constEnd(), pts.begin());
+        std::copy(scoresTmp.constBegin(), scoresTmp.constEnd(), scores.begin());
+        std::copy(statsTmp.constBegin(), statsTmp.constEnd(), stats.begin());
+        std::copy(rankTmp.constBegin(), rankTmp.constEnd(), rank.begin());
+        std::copy(crowdTmp.constBegin(), crowdTmp.constEnd(), crowd.begin());
+
+        recordGeneration(gen, breedUs);
         if (cbProgress) cbProgress(gen, bestScore);
+
+        if (m_gapStop > 0.0 && optimalityGap(bestScore) <= m_gapStop)
+            break;
+        if (m_timeBudgetMs > 0 && runTimer.elapsed() >= m_timeBudgetMs)
+            break;
+        if (m_stopFlag && m_stopFlag->load(std::memory_order_relaxed))
+            break;
+    }
+
+    // frente final: rank 0 da população, sem vetores de objetivos repetidos
+    QVector<int> front;
+    for (int i = 0; i < N; ++i)
+        if (rank[i] == 0) front.append(i);
+    std::sort(front.begin(), front.end(), [&](int a, int b) {
+        for (int m = 0; m < 3; ++m)
+            if (pts[a].f[m] != pts[b].f[m]) return pts[a].f[m] < pts[b].f[m];
+        return a < b;
+    });
+    QJsonArray frontArr;
+    const MOPoint *prev = nullptr;
+    for (int id : front) {
+        const MOPoint &p = pts[id];
+        if (prev && prev->f[0] == p.f[0] && prev->f[1] == p.f[1] && prev->f[2] == p.f[2])
+            continue;
+        prev = &p;
+
+        EvalStats s;
+        QVector<FlightInstance> flightsTmp;
+        QVector<QVariantMap> paxTmp;
+        const double sc = evaluateChromosome(pop[id], s, flightsTmp, paxTmp);
+        QJsonObject o = statsToJson(s);
+        o["score"]    = sc;
+        o["feasible"] = (p.viol == 0.0);
+        o["flights"]  = flightsToJson(flightsTmp);
+        frontArr.append(o);
     }
 
+    if (m_metrics) m_metrics->runFinished();
+
+    result = buildResult(bestScore, bestStats, bestFlights, bestPaxAssignments, gaHistory);
+    collectTopSchedules(pop, scores, result);
+
+    QJsonArray objectives;
+    objectives.append("served_total:max");
+    objectives.append("total_travel_time_min:min");
+    objectives.append("used_aircraft:min");
+    QJsonObject paretoRoot;
+    paretoRoot["objectives"]      = objectives;
+    paretoRoot["constraint"]      = QString("num_flights <= %1").arg(GAConst::MaxFlights);
+    paretoRoot["generations_run"] = qMax(0, gaHistory.size() - 1);
+    paretoRoot["front"]           = frontArr;
+    result.paretoJson = QJsonDocument(paretoRoot);
+    result.summaryText += QString("Pareto front: %1 solutions\n").arg(frontArr.size());
+    return result;
+}
+
+GAResult GAEngine::buildResult(double bestScore, const EvalStats &bestStats,
+                               const QVector<FlightInstance> &bestFlights,
+                               const QVector<QVariantMap> &bestPaxAssignments,
+                               const QJsonArray &gaHistory) const
+{
+    GA_TRACE_SCOPE("buildResult", "output");
+    GAResult result;
+
     // JSON de saída (voos + resumo)
-    QJsonObject summary;
-    summary["served_total"]          = bestStats.servedTotal;
-    summary["served_direct"]         = bestStats.servedDirect;
-    summary["served_1hop"]           = bestStats.servedOneHop;
-    summary["unserved"]              = bestStats.unserved;
-    summary["num_flights"]           = bestStats.numFlights;
-    summary["used_aircraft"]         = bestStats.usedAircraft;
-    summary["total_travel_time_min"] = (double)bestStats.totalTravelTime;
+    QJsonObject summary = statsToJson(bestStats);
 
     QJsonArray airportsArr;
-    for (const Airport &a : m_airports) {
+    for (const Airport &a : m_data->airports) {
         QJsonObject ao;
         ao["id"]   = a.id;
         ao["code"] = a.code;
@@ -786,26 +2798,7 @@ GAResult GAEngine::runGA(int population, int generations,
         airportsArr.append(ao);
     }
 
-    QJsonArray flightsArr;
-    for (const FlightInstance &f : bestFlights) {
-        if (f.aircraftIdx < 0) continue;
-
-        QJsonObject o;
-        o["tmpl_id"]      = f.tmplId;
-        o["route_id"]     = f.routeId;
-        o["orig_id"]      = f.orig;
-        o["dest_id"]      = f.dest;
-        o["dep_min"]      = f.depMin;
-        o["arr_min"]      = f.arrMin;
-        o["dep_hhmm"]     = formatTimeHHMM(f.depMin);
-        o["arr_hhmm"]     = formatTimeHHMM(f.arrMin);
-        o["aircraft_idx"] = f.aircraftIdx;
-        if (f.aircraftIdx >= 0 && f.aircraftIdx < m_fleet.aircraftIds.size())
-            o["aircraft_id"] = m_fleet.aircraftIds[f.aircraftIdx];
-        o["capacity"]     = f.capacity;
-        o["used_seats"]   = f.usedSeats;
-        flightsArr.append(o);
-    }
+    QJsonArray flightsArr = flightsToJson(bestFlights);
 
     QJsonObject root;
     root["summary"]  = summary;
@@ -815,9 +2808,47 @@ GAResult GAEngine::runGA(int population, int generations,
     result.bestScore = bestScore;
     result.fullJson  = QJsonDocument(root);
 
+    result.bestStats          = bestStats;
+    result.bestFlights        = bestFlights;
+    result.bestPaxAssignments = bestPaxAssignments;
+    result.history            = gaHistory;
+
     // JSON de histórico do GA (evolução por geração)
+    QJsonObject scenario;
+    scenario["day_start"]      = m_data->params.dayStart;
+    scenario["day_end"]        = m_data->params.dayEnd;
+    scenario["slot_min"]       = m_data->params.slotMin;
+    scenario["turnaround_min"] = m_data->params.turnaroundMin;
+    scenario["min_conn_min"]   = m_data->params.minConnMin;
+    scenario["num_days"]       = m_data->params.numDays;
+    scenario["num_genes"]      = m_data->allFlights.size();
+    scenario["chromosome"]     = sparseChromosomes() ? "sparse" : "dense";
+
+    QJsonObject bound;
+    bound["score_upper_bound"]  = m_scoreUpperBound;
+    bound["served_upper_bound"] = (double)m_servedUpperBound;
+    bound["total_demand"]       = (double)m_totalDemand;
+    bound["final_gap"]          = optimalityGap(bestScore);
+    bound["gap_stop"]           = m_gapStop;
+    bound["generations_run"]    = qMax(0, gaHistory.size() - 1);
+
+    QJsonObject params;
+    params["p_cross"]         = m_gaParams.pCross;
+    params["p_mut"]           = m_gaParams.pMut;
+    params["elite_frac"]      = m_gaParams.eliteFrac;
+    params["tournament_size"] = m_gaParams.tournamentSize;
+
     QJsonObject histRoot;
     histRoot["evolution"] = gaHistory;
+    histRoot["bound"]     = bound;
+    histRoot["ga_params"] = params;
+    histRoot["scenario"]  = scenario;
+    if (!m_warmStart.isEmpty()) {
+        QJsonObject warm;
+        warm["seeded_flights"]  = m_warmStart.size();
+        warm["dropped_flights"] = m_warmStartDropped;
+        histRoot["warm_start"]  = warm;
+    }
     result.evolutionJson  = QJsonDocument(histRoot);
 
     // JSON de passageiros
@@ -834,14 +2865,83 @@ GAResult GAEngine::runGA(int population, int generations,
     txt += QString("Served total: %1\n").arg(bestStats.servedTotal);
     txt += QString("   direct   : %1\n").arg(bestStats.servedDirect);
     txt += QString("   1-hop    : %1\n").arg(bestStats.servedOneHop);
+    txt += QString("   2+ hops  : %1\n").arg(bestStats.servedMultiHop);
     txt += QString("Unserved passengers: %1\n").arg(bestStats.unserved);
     txt += QString("Flights used: %1\n").arg(bestStats.numFlights);
     txt += QString("Aircraft used: %1 / %2\n")
                .arg(bestStats.usedAircraft)
-               .arg(m_fleet.numAircraft);
+               .arg(m_data->fleet.numAircraft);
+    if (m_data->fleet.types.size() > 1) {
+        QVector<QSet<int>> usedByType(m_data->fleet.types.size());
+        for (const FlightInstance &f : bestFlights)
+            if (f.aircraftIdx >= 0) usedByType[f.typeIdx].insert(f.aircraftIdx);
+        for (int t = 0; t < m_data->fleet.types.size(); ++t) {
+            const AircraftType &type = m_data->fleet.types[t];
+            txt += QString("   %1 (%2 seats): %3 / %4\n")
+                       .arg(type.name).arg(type.seats)
+                       .arg(usedByType[t].size()).arg(type.count);
+        }
+    }
     txt += QString("Total travel time (min * pax): %1\n")
                .arg((qlonglong)bestStats.totalTravelTime);
+    if (!m_data->slotLimits.isEmpty()) {
+        txt += QString("Airport slots: %1 flights refused by capacity, %2 templates removed by curfews\n")
+                   .arg(bestStats.slotRejected)
+                   .arg(m_data->curfewFiltered);
+    }
+    txt += QString("Upper bound: %1 (served <= %2) | gap %3%\n")
+               .arg(m_scoreUpperBound, 0, 'f', 0)
+               .arg((qlonglong)m_servedUpperBound)
+               .arg(100.0 * optimalityGap(bestScore), 0, 'f', 2);
+    if (!m_warmStart.isEmpty()) {
+        txt += QString("Warm start: %1 flights seeded, %2 dropped\n")
+                   .arg(m_warmStart.size())
+                   .arg(m_warmStartDropped);
+    }
 
     result.summaryText = txt;
     return result;
 }
+
+QJsonObject GAEngine::statsToJson(const EvalStats &stats) const
+{
+    QJsonObject o;
+    o["served_total"]          = stats.servedTotal;
+    o["served_direct"]         = stats.servedDirect;
+    o["served_1hop"]           = stats.servedOneHop;
+    o["served_multihop"]       = stats.servedMultiHop;
+    o["unserved"]              = stats.unserved;
+    o["num_flights"]           = stats.numFlights;
+    o["used_aircraft"]         = stats.usedAircraft;
+    o["total_travel_time_min"] = (double)stats.totalTravelTime;
+    if (!m_data->slotCapacity.isEmpty())
+        o["slot_rejected"]     = stats.slotRejected;
+    return o;
+}
+
+QJsonArray GAEngine::flightsToJson(const QVector<FlightInstance> &flights) const
+{
+    QJsonArray flightsArr;
+    for (const FlightInstance &f : flights) {
+        if (f.aircraftIdx < 0) continue;
+
+        QJsonObject o;
+        o["tmpl_id"]      = f.tmplId;
+        o["route_id"]     = f.routeId;
+        o["orig_id"]      = f.orig;
+        o["dest_id"]      = f.dest;
+        o["dep_min"]      = f.depMin;
+        o["arr_min"]      = f.arrMin;
+        o["dep_hhmm"]     = formatTimeHHMM(f.depMin);
+        o["arr_hhmm"]     = formatTimeHHMM(f.arrMin);
+        o["aircraft_idx"] = f.aircraftIdx;
+        if (f.aircraftIdx >= 0 && f.aircraftIdx < m_data->fleet.aircraftIds.size())
+            o["aircraft_id"] = m_data->fleet.aircraftIds[f.aircraftIdx];
+        if (!m_data->fleet.types[f.typeIdx].name.isEmpty())
+            o["aircraft_type"] = m_data->fleet.types[f.typeIdx].name;
+        o["capacity"]     = f.capacity;
+        o["used_seats"]   = f.usedSeats;
+        flightsArr.append(o);
+    }
+    return flightsArr;
+}
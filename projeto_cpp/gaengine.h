@@ -4,10 +4,84 @@
 #include <QObject>
 #include <QVector>
 #include <QJsonDocument>
+#include <QJsonArray>
+#include <QVariantMap>
 #include <QSet>
+#include <QHash>
+#include <QPair>
+#include <QSharedPointer>
+#include <QRandomGenerator>
 #include <QtGlobal>
+#include <atomic>
 #include <functional>
 
+// Constantes do cenário padrão (malha diária 06:00–22:00, slots de 60 min).
+// Valores default de ScenarioParams; meta.json pode sobrescrevê-los.
+namespace GAConst {
+constexpr int DayStart   = 6 * 60;
+constexpr int DayEnd     = 22 * 60;
+constexpr int SlotMin    = 60;
+constexpr int Turnaround = 60;
+constexpr int MinConnMin = 60;
+constexpr int NumDays    = 1;
+constexpr int MinutesPerDay = 24 * 60;
+
+// até este número de aeroportos usa-se o kernel de avaliação com
+// matrizes de tamanho fixo (std::array), escolhido em loadData
+constexpr int MaxFixedAirports = 32;
+
+// acima deste número de genes o modo Auto usa cromossomos esparsos
+constexpr int SparseAutoGenes = 20000;
+
+// máximo de pernas por itinerário no roteador time-expanded
+constexpr int MaxLegs = 3;
+
+// penalização de score acima deste número de voos
+constexpr int MaxFlights = 1000;
+
+// fração dos filhos rejeitados na pré-triagem que ainda é avaliada,
+// só para medir a acurácia da triagem
+constexpr double ScreenAuditRate = 0.05;
+
+// mutação adaptativa: colapso = Hamming médio abaixo desta fração dos
+// genes ativos, ou mais desta fração de indivíduos repetidos
+constexpr double DiversityCollapse    = 0.05;
+constexpr double DuplicateCollapse    = 0.5;
+constexpr double AdaptiveMaxMutFactor = 10.0; // teto de pMut (x a taxa base)
+constexpr int    AdaptiveStallGens    = 10;   // colapso sem melhora -> imigrantes
+constexpr double ImmigrantFrac        = 0.2;  // fração da população trocada
+
+// crossover por blocos: largura da janela de partida dos blocos de tempo
+constexpr int CrossoverTimeBlockMin = 180;
+}
+
+// Numeração dos genes em allFlights: rota a rota (padrão) ou agrupada por
+// aeroporto de origem e horário de partida, para que o crossover por
+// blocos troque rotações inteiras de um aeroporto
+enum class GeneLayout { Route, AirportTime };
+
+// Parâmetros de tempo do cenário (meta.json)
+struct ScenarioParams {
+    int dayStart      = GAConst::DayStart;   // primeira partida do dia (min)
+    int dayEnd        = GAConst::DayEnd;     // última chegada do dia (min)
+    int slotMin       = GAConst::SlotMin;    // granularidade dos slots
+    int turnaroundMin = GAConst::Turnaround; // solo mínimo da aeronave
+    int minConnMin    = GAConst::MinConnMin; // conexão mínima do passageiro
+    int numDays       = GAConst::NumDays;    // horizonte em dias
+    GeneLayout geneLayout = GeneLayout::Route;
+};
+
+// Limites de um aeroporto (slots.json): movimentos por hora do dia
+// (-1 = sem limite) e janelas de toque de recolher [de, até) em minutos do
+// dia, que podem cruzar a meia-noite
+struct AirportSlotLimits {
+    QVector<int> depPerHour;       // 24 valores
+    QVector<int> arrPerHour;       // 24 valores
+    QVector<QPair<int, int>> curfews;
+};
+
+class GAMetrics;
+
 struct Airport {
     int id;
     QString code;
@@ -29,10 +103,20 @@ struct ODDemand {
     int demand;
 };
 
+// Tipo de aeronave; as aeronaves de um tipo têm índices contíguos
+// [firstAircraft, firstAircraft + count)
+struct AircraftType {
+    QString name;
+    int seats;
+    int count;
+    int firstAircraft;
+};
+
 struct FleetInfo {
     int numAircraft;
-    int seatsPerAircraft;
-    QStringList aircraftIds; // tamanho numAircraft
+    int seatsPerAircraft;        // maior capacidade entre os tipos
+    QStringList aircraftIds;     // tamanho numAircraft
+    QVector<AircraftType> types; // >= 1; frota homogênea = um tipo sem nome
 };
 
 struct FlightTemplate {
@@ -42,6 +126,7 @@ struct FlightTemplate {
     int dest;
     int depMin;  // em minutos desde 00:00
     int arrMin;
+    int typeIdx; // tipo de aeronave (índice em fleet.types)
 };
 
 struct FlightInstance {
@@ -52,6 +137,7 @@ struct FlightInstance {
     int depMin;
     int arrMin;
     int aircraftIdx; // índice da aeronave usada (-1 se sem aeronave)
+    int typeIdx;     // tipo de aeronave pedido pelo gene
     int capacity;    // assentos
     int usedSeats;   // pax alocados
 };
@@ -60,10 +146,70 @@ struct EvalStats {
     int servedTotal = 0;
     int servedDirect = 0;
     int servedOneHop = 0;
+    int servedMultiHop = 0;   // 3 ou mais pernas (roteador time-expanded)
     int unserved = 0;
     int numFlights = 0;
     int usedAircraft = 0;
     long long totalTravelTime = 0; // soma (arr - dep) * pax
+    int slotRejected = 0;          // voos recusados por capacidade de slot
+};
+
+// Parâmetros dos operadores do GA (runGA)
+struct GAParams {
+    double pCross         = 0.8;   // probabilidade de crossover por par
+    double pMut           = 0.01;  // probabilidade de flip por gene
+    double eliteFrac      = 0.1;   // fração copiada sem alteração
+    int    tournamentSize = 2;
+};
+
+// leitura de um arquivo de entrada por loadScenario
+struct InputFileStats {
+    QString file;
+    qint64 bytes = 0;
+    double parseMs = 0.0;
+};
+
+// Cenário carregado: entradas e universo de voos (genes). Imutável depois
+// de GAEngine::loadScenario; vários engines (e threads) podem compartilhar
+// o mesmo objeto sem cópia
+struct ScenarioData {
+    QVector<Airport>        airports;
+    QVector<Route>          routes;
+    QVector<ODDemand>       od;
+    FleetInfo               fleet;
+    ScenarioParams          params;
+    QVector<FlightTemplate> allFlights;   // universo de voos possíveis
+    QSet<quint64>           forbiddenOD;  // pares (orig,dest) proibidos
+    bool                    fixedKernelAvailable = false;
+
+    // restrições de aeroporto: toque de recolher já filtrado dos genes;
+    // a capacidade vira um índice compacto de slot (aeroporto, hora do
+    // horizonte, partida/chegada) por gene, contado em cada avaliação
+    QHash<int, AirportSlotLimits> slotLimits;   // por id de aeroporto
+    QVector<int>            geneDepSlot;  // -1 = partida sem limite
+    QVector<int>            geneArrSlot;  // -1 = chegada sem limite
+    QVector<int>            slotCapacity; // por slot compacto
+    int                     curfewFiltered = 0; // templates descartados
+
+    // blocos contíguos de genes para o crossover (offsets, blocos + 1):
+    // mesma origem (AirportTime) ou rota (Route), e dentro deles a mesma
+    // janela de partida de GAConst::CrossoverTimeBlockMin
+    QVector<int>            geneBlocks;
+    QVector<int>            geneTimeBlocks;
+
+    // airports, routes, passengers, fleet, forbidden (nesta ordem)
+    QVector<InputFileStats> inputStats;
+};
+using ScenarioPtr = QSharedPointer<const ScenarioData>;
+
+// Variação de um cenário base aplicada por engine (estudos what-if): os
+// genes continuam os do cenário base, os voos de pares proibidos aqui são
+// descartados na avaliação
+struct ScenarioOverlay {
+    QString name;
+    QSet<quint64> forbiddenOD;             // chaves GAEngine::odKey
+    double demandScale = 1.0;              // multiplicador de toda a demanda
+    QHash<quint64, double> odDemandScale;  // multiplicador por par OD
 };
 
 struct GAResult {
@@ -72,6 +218,19 @@ struct GAResult {
     QJsonDocument fullJson;       // voos + resumo
     QJsonDocument passengersJson; // mapeamento OD->voos
     QJsonDocument evolutionJson;  // histórico geração a geração do GA
+    QJsonDocument paretoJson;     // frente de Pareto (só no modo multiobjetivo)
+
+    // melhor solução em forma estruturada (mesmo conteúdo dos JSONs acima),
+    // para quem consome o resultado em memória
+    EvalStats               bestStats;
+    QVector<FlightInstance> bestFlights;
+    QVector<QVariantMap>    bestPaxAssignments;
+    QJsonArray              history;   // = evolutionJson["evolution"]
+
+    // melhores cromossomos distintos da população final (setKeepTopSchedules),
+    // do melhor para o pior
+    QVector<double>                  topScores;
+    QVector<QVector<FlightInstance>> topFlights;
 };
 
 class GAEngine : public QObject
@@ -87,34 +246,257 @@ public:
                   const QString &forbiddenPath,
                   QString &error);
 
+    // carrega um cenário compartilhável; nullptr (e error) se falhar
+    static ScenarioPtr loadScenario(const QString &airportsPath,
+                                    const QString &routesPath,
+                                    const QString &passengersPath,
+                                    const QString &fleetPath,
+                                    const QString &forbiddenPath,
+                                    QString &error);
+    // usa um cenário já carregado, com uma variação opcional por cima
+    void setScenario(const ScenarioPtr &data,
+                     const ScenarioOverlay &overlay = ScenarioOverlay());
+    // cópia do cenário com os genes renumerados na ordem pedida (os ids
+    // de genes mudam; warm start e planos casam por voo, não por id)
+    static ScenarioPtr withGeneLayout(const ScenarioPtr &data, GeneLayout layout);
+    ScenarioPtr scenario() const { return m_data; }
+    const ScenarioOverlay &overlay() const { return m_overlay; }
+
+    static quint64 odKey(int orig, int dest);
+
+    // warm start: semeia a população inicial com uma solução anterior
+    // (flights_ga.json). Deve ser chamado depois de loadData.
+    bool loadWarmStart(const QString &flightsPath, QString &error);
+    void clearWarmStart();
+    int warmStartSeeded() const { return m_warmStart.size(); }
+    int warmStartDropped() const { return m_warmStartDropped; }
+    const QVector<int> &warmStartGenes() const { return m_warmStart; }
+
+    // Replanejamento (ver garecovery.h). Todos são desfeitos por setScenario.
+    // Genes fixos: forcedOn sempre ligados, forcedOff sempre desligados; a
+    // mutação só sorteia entre os demais e o reparo não desliga os fixos
+    void setFrozenGenes(const QVector<int> &forcedOn, const QVector<int> &forcedOff);
+    void clearFrozenGenes();
+    int freeGenes() const { return m_frozen.isEmpty() ? numGenes() : m_freeGenes.size(); }
+    // genes descartados na avaliação, além dos da variação do cenário
+    void blockGenes(const QVector<int> &genes);
+    // aeronave i não decola a partir do minuto groundedFrom[i] (INT_MAX =
+    // sempre disponível); vetor vazio = frota toda disponível
+    void setAircraftGroundedFrom(const QVector<int> &groundedFrom) { m_acGroundedFrom = groundedFrom; }
+    // limite de tempo de parede de runGA (ms); 0 = só o número de gerações
+    void setTimeBudgetMs(qint64 ms) { m_timeBudgetMs = qMax<qint64>(0, ms); }
+    // cancelamento de outra thread: runGA para ao fim da geração em que
+    // *flag vira true e devolve o melhor até ali (nullptr = sem flag)
+    void setStopFlag(const std::atomic<bool> *flag) { m_stopFlag = flag; }
+
+    // Representação do cromossomo no GA: vetor denso de bits (um por
+    // template) ou lista ordenada dos genes ativos (esparso)
+    enum class ChromosomeMode { Auto, Dense, Sparse };
+    ChromosomeMode chromosomeMode() const { return m_chromMode; }
+    void setChromosomeMode(ChromosomeMode mode) { m_chromMode = mode; }
+    bool sparseChromosomes() const;
+
+    // Crossover: um ponto de corte na ordem dos genes, ou cada bloco de
+    // geneBlocks (aeroporto de origem / rota) ou de geneTimeBlocks vindo
+    // inteiro de um dos pais, sorteado por bloco
+    enum class CrossoverMode { OnePoint, AirportBlocks, TimeBlocks };
+    CrossoverMode crossoverMode() const { return m_crossoverMode; }
+    void setCrossoverMode(CrossoverMode mode) { m_crossoverMode = mode; }
+
+    const ScenarioParams &scenarioParams() const { return m_data->params; }
+
+    // Roteamento de passageiros: guloso (direto / 1 conexão, rápido) ou
+    // rede expandida no tempo com até maxLegs pernas por itinerário
+    enum class RoutingMode { TimeExpanded, Greedy };
+    RoutingMode routingMode() const { return m_routingMode; }
+    void setRoutingMode(RoutingMode mode) { m_routingMode = mode; }
+    int maxLegs() const { return m_maxLegs; }
+    void setMaxLegs(int legs) { m_maxLegs = qMax(1, legs); }
+
+    // Pré-triagem dos filhos antes da avaliação completa: Bound rejeita só
+    // quem comprovadamente não alcança a mediana da geração dos pais (limite
+    // superior por capacidade de assentos); Surrogate também desconta a
+    // penalidade provável de excesso de voos
+    enum class ScreeningMode { Off, Bound, Surrogate };
+    ScreeningMode screeningMode() const { return m_screening; }
+    void setScreeningMode(ScreeningMode mode) { m_screening = mode; }
+
+    // Limite superior do score (relaxação calculada em loadData) e parada
+    // antecipada quando o gap relativo (UB - melhor) / |UB| fica abaixo do
+    // limiar; 0 desliga a parada
+    double scoreUpperBound() const { return m_scoreUpperBound; }
+    long long servedUpperBound() const { return m_servedUpperBound; }
+    double gapStopThreshold() const { return m_gapStop; }
+    void setGapStopThreshold(double gap) { m_gapStop = qMax(0.0, gap); }
+    double optimalityGap(double score) const;
+
+    // Modo multiobjetivo (NSGA-II): em vez dos pesos fixos do score, evolui
+    // a frente de Pareto de (passageiros atendidos, tempo total de viagem,
+    // aeronaves usadas); voos acima de GAConst::MaxFlights viram restrição.
+    // O flights_ga.json continua sendo o melhor indivíduo pelo score.
+    bool multiObjective() const { return m_multiObjective; }
+    void setMultiObjective(bool on) { m_multiObjective = on; }
+
+    const GAParams &gaParams() const { return m_gaParams; }
+    void setGAParams(const GAParams &params);
+
+    // semente do gerador do engine (população inicial, crossover, mutação,
+    // torneio); sem setSeed cada engine começa com uma semente aleatória
+    void setSeed(quint32 seed) { m_rng.seed(seed); }
+
+    // telemetria ao vivo (opcional, ver MetricsServer); o engine só escreve
+    void setMetrics(const QSharedPointer<GAMetrics> &metrics) { m_metrics = metrics; }
+
     using ProgressCallback = std::function<void(int gen, double bestScore)>;
 
     GAResult runGA(int population, int generations,
                    ProgressCallback cbProgress = ProgressCallback());
 
-private:
-    // Dados de entrada
-    QVector<Airport>    m_airports;
-    QVector<Route>      m_routes;
-    QVector<ODDemand>   m_od;
-    FleetInfo           m_fleet;
-    QVector<FlightTemplate> m_allFlights;  // universo de voos possíveis
-    QSet<quint64>       m_forbiddenOD;     // pares (orig,dest) proibidos
-
-    // GA
-    QVector<QVector<bool>> initPopulation(int popSize, int numGenes);
+    // droppedGenes (opcional) recebe os genes ativos descartados: voos sem
+    // aeronave disponível e voos vazios removidos pelo pruning
     double evaluateChromosome(const QVector<bool> &chrom,
                               EvalStats &stats,
                               QVector<FlightInstance> &bestFlights,
-                              QVector<QVariantMap> &paxAssignments) const;
+                              QVector<QVariantMap> &paxAssignments,
+                              QVector<int> *droppedGenes = nullptr) const;
+    // cromossomo esparso: ids dos genes ativos em ordem crescente
+    double evaluateChromosome(const QVector<int> &activeGenes,
+                              EvalStats &stats,
+                              QVector<FlightInstance> &bestFlights,
+                              QVector<QVariantMap> &paxAssignments,
+                              QVector<int> *droppedGenes = nullptr) const;
+
+    // Robustez à demanda (ver garobust.h). evaluateRouting reaproveita a
+    // malha e as aeronaves de flights (ex.: GAResult::bestFlights) e só
+    // refaz o roteamento de passageiros com outra demanda diária por par de
+    // scenario()->od; sem pruning, voos vazios continuam voando. Malha
+    // vazia pontua como toda a demanda sem atendimento
+    double evaluateRouting(const QVector<FlightInstance> &flights, const int *odDemand,
+                           EvalStats &stats) const;
+    const QVector<int> &odDemand() const { return m_odDemand; }
+    // objetivo do GA = média (quantile < 0) ou quantil dos scores da malha
+    // em um conjunto fixo de amostras de demanda; vazio = demanda nominal
+    void setRobustObjective(const QVector<QVector<int>> &demandSamples, double quantile = -1.0);
+    int robustSamples() const { return m_demandSamples.size(); }
+    // quantos cromossomos distintos da população final vão para
+    // GAResult::topFlights (0 = nenhum)
+    void setKeepTopSchedules(int k) { m_keepTop = qMax(0, k); }
+
+    // Mutação adaptativa (só GA escalar): pMut sobe quando a diversidade
+    // da população colapsa e imigrantes aleatórios entram se o colapso
+    // persistir sem melhora (ver GAConst::DiversityCollapse). As métricas de
+    // diversidade vão para o histórico com ou sem ela
+    bool adaptiveMutation() const { return m_adaptiveMutation; }
+    void setAdaptiveMutation(bool on) { m_adaptiveMutation = on; }
+
+    // reparo lamarckiano: zera no cromossomo os genes descartados na avaliação
+    bool repairEnabled() const { return m_repair; }
+    void setRepairEnabled(bool on) { m_repair = on; }
+
+    int numGenes() const { return m_data->allFlights.size(); }
+    int numAirports() const { return m_data->airports.size(); }
+
+    // kernel especializado (<= GAConst::MaxFixedAirports aeroportos)
+    bool fixedKernelAvailable() const { return m_data->fixedKernelAvailable; }
+    bool fixedKernelEnabled() const { return m_useFixedKernel; }
+    void setFixedKernelEnabled(bool on) { m_useFixedKernel = on && m_data->fixedKernelAvailable; }
+
+private:
+    // Dados de entrada (compartilhados) e variação deste engine
+    ScenarioPtr         m_data;
+    ScenarioOverlay     m_overlay;
+    QVector<int>        m_odDemand;            // demanda diária efetiva por par de m_data->od
+    QVector<char>       m_geneBlocked;         // genes proibidos pela variação (vazio = nenhum)
+    QVector<char>       m_frozen;              // 0 livre, 1 fixo ligado, 2 fixo desligado (vazio = nenhum)
+    QVector<int>        m_frozenOn;            // ordenados
+    QVector<int>        m_frozenOff;
+    QVector<int>        m_freeGenes;           // genes não fixos, ordenados
+    QVector<int>        m_acGroundedFrom;      // por aeronave (vazio = todas disponíveis)
+    qint64              m_timeBudgetMs         = 0;
+    const std::atomic<bool> *m_stopFlag        = nullptr;
+    QVector<QVector<int>> m_demandSamples;     // objetivo robusto (vazio = nominal)
+    double              m_robustQuantile       = -1.0;
+    int                 m_keepTop              = 0;
+    bool                m_adaptiveMutation     = false;
+    bool                m_useFixedKernel       = false;
+    bool                m_repair               = false;
+    QVector<int>        m_warmStart;           // genes ativos da solução anterior
+    int                 m_warmStartDropped     = 0;
+    ChromosomeMode      m_chromMode            = ChromosomeMode::Auto;
+    CrossoverMode       m_crossoverMode        = CrossoverMode::OnePoint;
+    RoutingMode         m_routingMode          = RoutingMode::TimeExpanded;
+    int                 m_maxLegs              = GAConst::MaxLegs;
+    ScreeningMode       m_screening            = ScreeningMode::Off;
+    QVector<long long>  m_demandFrom;          // demanda do horizonte por origem
+    QVector<long long>  m_demandTo;            // e por destino
+    long long           m_totalDemand          = 0;
+    double              m_scoreUpperBound      = 0.0;
+    long long           m_servedUpperBound     = 0;
+    double              m_gapStop              = 0.0;
+    bool                m_multiObjective       = false;
+    GAParams            m_gaParams;
+    mutable QRandomGenerator m_rng;
+    QSharedPointer<GAMetrics> m_metrics;
+
+    // GA (Chrom = QVector<bool> denso ou QVector<int> esparso)
+    template <class Chrom>
+    GAResult runGAImpl(int population, int generations, ProgressCallback cbProgress);
+    template <class Chrom>
+    GAResult runNSGA2Impl(int population, int generations, ProgressCallback cbProgress);
+    void initPopulation(QVector<QVector<bool>> &pop, int popSize) const;
+    void initPopulation(QVector<QVector<int>> &pop, int popSize) const;
+    template <class Net>
+    double evaluateKernel(const int *genes, int numActive,
+                          EvalStats &stats,
+                          QVector<FlightInstance> &bestFlights,
+                          QVector<QVariantMap> &paxAssignments,
+                          QVector<int> *droppedGenes,
+                          bool slotRetry = true) const;
+    template <class Net>
+    void routePassengers(QVector<FlightInstance> &flights, const int *odDemand,
+                         EvalStats &stats, QVector<QVariantMap> *paxAssignments) const;
+    double scoreFlights(const EvalStats &stats, const QVector<FlightInstance> &flights) const;
+    double robustScore(const QVector<FlightInstance> &flights) const;
+    template <class Chrom>
+    void collectTopSchedules(const QVector<Chrom> &pop, const QVector<double> &scores,
+                             GAResult &result) const;
+    double evaluateGenes(const int *genes, int numActive,
+                         EvalStats &stats,
+                         QVector<FlightInstance> &bestFlights,
+                         QVector<QVariantMap> &paxAssignments,
+                         QVector<int> *droppedGenes) const;
     void crossover(const QVector<bool> &p1, const QVector<bool> &p2,
                    QVector<bool> &c1, QVector<bool> &c2, double pCross) const;
+    void crossover(const QVector<int> &p1, const QVector<int> &p2,
+                   QVector<int> &c1, QVector<int> &c2, double pCross) const;
     void mutate(QVector<bool> &ind, double pMut) const;
+    void mutate(QVector<int> &ind, double pMut) const;
+    void removeGenes(QVector<bool> &ind, QVector<int> &genes) const;
+    void removeGenes(QVector<int> &ind, QVector<int> &genes) const;
+    void immigrant(QVector<bool> &ind, double density) const;
+    void immigrant(QVector<int> &ind, double density) const;
+    void applyFrozen(QVector<bool> &ind) const;
+    void applyFrozen(QVector<int> &ind) const;
+    template <class Chrom>
+    double screenEstimate(const Chrom &ind) const;
+    GAResult buildResult(double bestScore, const EvalStats &bestStats,
+                         const QVector<FlightInstance> &bestFlights,
+                         const QVector<QVariantMap> &bestPaxAssignments,
+                         const QJsonArray &gaHistory) const;
+    QJsonObject statsToJson(const EvalStats &stats) const;
+    QJsonArray flightsToJson(const QVector<FlightInstance> &flights) const;
 
     // helpers
-    void buildAllFlights();
+    static bool loadScenarioParams(const QString &metaPath, ScenarioParams &params,
+                                   QString &error);
+    static bool loadSlotLimits(const QString &slotsPath, ScenarioData &data,
+                               QString &error);
+    static void buildAllFlights(ScenarioData &data);
+    static void buildSlotIndex(ScenarioData &data);
+    static void buildGeneBlocks(ScenarioData &data);
+    bool isForbidden(int orig, int dest) const;
+    void computeUpperBound();
     QString formatTimeHHMM(int minutes) const;
-    quint64 odKey(int orig, int dest) const;
 };
 
 #endif // GAENGINE_H
@@ -0,0 +1,383 @@
+// gajsonstream.cpp
+#include "gajsonstream.h"
+
+#include <QIODevice>
+
+#include <climits>
+#include <cmath>
+
+namespace {
+
+// bytes lidos do dispositivo por vez
+constexpr int ChunkSize = 256 * 1024;
+
+int hexValue(int c)
+{
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+void appendUtf8(QByteArray &out, uint cp)
+{
+    if (cp < 0x80) {
+        out += char(cp);
+    } else if (cp < 0x800) {
+        out += char(0xC0 | (cp >> 6));
+        out += char(0x80 | (cp & 0x3F));
+    } else if (cp < 0x10000) {
+        out += char(0xE0 | (cp >> 12));
+        out += char(0x80 | ((cp >> 6) & 0x3F));
+        out += char(0x80 | (cp & 0x3F));
+    } else {
+        out += char(0xF0 | (cp >> 18));
+        out += char(0x80 | ((cp >> 12) & 0x3F));
+        out += char(0x80 | ((cp >> 6) & 0x3F));
+        out += char(0x80 | (cp & 0x3F));
+    }
+}
+
+} // namespace
+
+JsonStreamReader::JsonStreamReader(QIODevice *device)
+    : m_dev(device)
+{
+}
+
+bool JsonStreamReader::fill()
+{
+    m_consumed += m_buf.size();
+    m_buf.resize(ChunkSize);
+    const qint64 n = m_dev->read(m_buf.data(), ChunkSize);
+    m_buf.resize(n > 0 ? int(n) : 0);
+    m_pos = 0;
+    return !m_buf.isEmpty();
+}
+
+void JsonStreamReader::skipWhitespace()
+{
+    for (int c = peekChar(); c == ' ' || c == '\n' || c == '\r' || c == '\t'; c = peekChar())
+        ++m_pos;
+}
+
+JsonStreamReader::Token JsonStreamReader::fail(const QString &msg)
+{
+    if (m_error.isEmpty())
+        m_error = QString("%1 at offset %2").arg(msg).arg(bytesRead());
+    m_token = Invalid;
+    return m_token;
+}
+
+JsonStreamReader::Token JsonStreamReader::next()
+{
+    if (m_pushedBack) {
+        m_pushedBack = false;
+        return m_token;
+    }
+    if (hasError())
+        return Invalid;
+
+    skipWhitespace();
+    int c = peekChar();
+    if (c == ',') {
+        if (m_stack.isEmpty() || !m_afterValue)
+            return fail("unexpected ','");
+        ++m_pos;
+        m_afterValue = false;
+        m_afterComma = true;
+        m_expectKey  = (m_stack.last() == '{');
+        skipWhitespace();
+        c = peekChar();
+    }
+
+    if (c < 0) {
+        if (!m_stack.isEmpty() || !m_rootDone)
+            return fail("unexpected end of file");
+        return m_token = EndOfInput;
+    }
+
+    if (c == '}' || c == ']') {
+        const char open = (c == '}') ? '{' : '[';
+        if (m_stack.isEmpty() || m_stack.last() != open || m_afterComma
+            || (open == '{' && !m_expectKey && !m_afterValue))
+            return fail(QString("unexpected '%1'").arg(QChar(c)));
+        ++m_pos;
+        m_stack.removeLast();
+        m_afterValue = true;
+        m_expectKey  = false;
+        m_rootDone   = m_stack.isEmpty();
+        return m_token = (c == '}') ? EndObject : EndArray;
+    }
+
+    if (m_afterValue)
+        return fail(m_stack.isEmpty() ? QString("trailing data") : QString("missing ','"));
+    m_afterComma = false;
+
+    if (m_expectKey) {
+        if (c != '"')
+            return fail("expected object key");
+        ++m_pos;
+        if (!readStringBody())
+            return Invalid;
+        skipWhitespace();
+        if (peekChar() != ':')
+            return fail("expected ':'");
+        ++m_pos;
+        m_expectKey = false;
+        return m_token = Key;
+    }
+
+    // valor
+    Token t;
+    switch (c) {
+    case '{':
+        ++m_pos;
+        m_stack.append('{');
+        m_expectKey = true;
+        return m_token = BeginObject;
+    case '[':
+        ++m_pos;
+        m_stack.append('[');
+        return m_token = BeginArray;
+    case '"':
+        ++m_pos;
+        if (!readStringBody())
+            return Invalid;
+        t = String;
+        break;
+    case 't':
+        if (!readLiteral("true"))
+            return Invalid;
+        m_bool = true;
+        t = Bool;
+        break;
+    case 'f':
+        if (!readLiteral("false"))
+            return Invalid;
+        m_bool = false;
+        t = Bool;
+        break;
+    case 'n':
+        if (!readLiteral("null"))
+            return Invalid;
+        t = Null;
+        break;
+    default:
+        if (c != '-' && (c < '0' || c > '9'))
+            return fail(QString("unexpected '%1'").arg(QChar(c)));
+        if (!readNumber())
+            return Invalid;
+        t = Number;
+        break;
+    }
+    m_afterValue = true;
+    m_rootDone   = m_stack.isEmpty();
+    return m_token = t;
+}
+
+bool JsonStreamReader::readStringBody()
+{
+    m_text.clear();
+    for (;;) {
+        if (m_pos >= m_buf.size() && !fill()) {
+            fail("unterminated string");
+            return false;
+        }
+        // trecho sem aspas nem escape copiado de uma vez
+        const char *p = m_buf.constData() + m_pos;
+        const char *end = m_buf.constData() + m_buf.size();
+        const char *q = p;
+        while (q < end && *q != '"' && *q != '\\')
+            ++q;
+        m_text.append(p, int(q - p));
+        m_pos += int(q - p);
+        if (q == end)
+            continue;
+
+        ++m_pos;
+        if (*q == '"')
+            return true;
+
+        // escape
+        const int e = peekChar();
+        if (e < 0) {
+            fail("unterminated string");
+            return false;
+        }
+        ++m_pos;
+        switch (e) {
+        case '"':  m_text += '"';  break;
+        case '\\': m_text += '\\'; break;
+        case '/':  m_text += '/';  break;
+        case 'b':  m_text += '\b'; break;
+        case 'f':  m_text += '\f'; break;
+        case 'n':  m_text += '\n'; break;
+        case 'r':  m_text += '\r'; break;
+        case 't':  m_text += '\t'; break;
+        case 'u': {
+            auto readHex4 = [this](uint &v) {
+                v = 0;
+                for (int i = 0; i < 4; ++i) {
+                    const int h = hexValue(peekChar());
+                    if (h < 0)
+                        return false;
+                    ++m_pos;
+                    v = (v << 4) | uint(h);
+                }
+                return true;
+            };
+            uint cp;
+            if (!readHex4(cp)) {
+                fail("invalid \\u escape");
+                return false;
+            }
+            // par substituto UTF-16
+            if (cp >= 0xD800 && cp < 0xDC00 && peekChar() == '\\') {
+                ++m_pos;
+                uint lo;
+                if (peekChar() != 'u' || (++m_pos, !readHex4(lo)) || lo < 0xDC00 || lo > 0xDFFF) {
+                    fail("invalid surrogate pair");
+                    return false;
+                }
+                cp = 0x10000 + ((cp - 0xD800) << 10) + (lo - 0xDC00);
+            }
+            appendUtf8(m_text, cp);
+            break;
+        }
+        default:
+            fail("invalid escape");
+            return false;
+        }
+    }
+}
+
+bool JsonStreamReader::readNumber()
+{
+    m_text.clear();
+    for (int c = peekChar();
+         (c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E';
+         c = peekChar()) {
+        m_text += char(c);
+        ++m_pos;
+    }
+    bool ok = false;
+    m_text.toDouble(&ok);
+    if (!ok) {
+        fail("invalid number");
+        return false;
+    }
+    return true;
+}
+
+bool JsonStreamReader::readLiteral(const char *word)
+{
+    for (const char *w = word; *w; ++w) {
+        if (peekChar() != *w) {
+            fail("invalid literal");
+            return false;
+        }
+        ++m_pos;
+    }
+    return true;
+}
+
+bool JsonStreamReader::readInt(int &v)
+{
+    v = 0;
+    const Token t = next();
+    if (t == Number) {
+        // como QJsonValue::toInt: só valores inteiros
+        const double d = m_text.toDouble();
+        if (d == std::floor(d) && d >= INT_MIN && d <= INT_MAX)
+            v = int(d);
+        return true;
+    }
+    unread();
+    return skipValue();
+}
+
+bool JsonStreamReader::readDouble(double &v)
+{
+    v = 0.0;
+    if (next() == Number) {
+        v = m_text.toDouble();
+        return true;
+    }
+    unread();
+    return skipValue();
+}
+
+bool JsonStreamReader::readString(QString &v)
+{
+    v.clear();
+    if (next() == String) {
+        v = QString::fromUtf8(m_text);
+        return true;
+    }
+    unread();
+    return skipValue();
+}
+
+bool JsonStreamReader::skipValue()
+{
+    int depth = 0;
+    do {
+        switch (next()) {
+        case BeginObject:
+        case BeginArray:
+            ++depth;
+            break;
+        case EndObject:
+        case EndArray:
+            --depth;
+            break;
+        case Key:
+            break;
+        case EndOfInput:
+            fail("unexpected end of file");
+            return false;
+        case Invalid:
+            return false;
+        default:
+            break;
+        }
+    } while (depth > 0);
+    return !hasError();
+}
+
+bool JsonStreamReader::readObject(const std::function<bool(const QByteArray &)> &field)
+{
+    if (next() != BeginObject) {
+        unread();
+        return skipValue();
+    }
+    for (;;) {
+        const Token t = next();
+        if (t == EndObject)
+            return true;
+        if (t != Key)
+            return false;
+        const QByteArray key = m_text;
+        if (!field(key))
+            return false;
+    }
+}
+
+bool JsonStreamReader::readArray(const std::function<bool()> &item)
+{
+    if (next() != BeginArray) {
+        unread();
+        return skipValue();
+    }
+    for (;;) {
+        const Token t = next();
+        if (t == EndArray)
+            return true;
+        if (t == Invalid)
+            return false;
+        unread();
+        if (!item())
+            return false;
+    }
+}
@@ -0,0 +1,94 @@
+// gajsonstream.h
+#ifndef GAJSONSTREAM_H
+#define GAJSONSTREAM_H
+
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+
+#include <functional>
+
+class QIODevice;
+
+// Leitor JSON incremental (pull): tokeniza o arquivo em blocos, sem
+// montar o QJsonDocument inteiro na memória. Usado por loadScenario para
+// encher os vetores do cenário direto enquanto lê, o que mantém o pico de
+// memória perto do tamanho dos dados finais mesmo com centenas de MB de
+// rotas/demanda.
+//
+// Uso típico (cada callback consome exatamente um valor):
+//   JsonStreamReader r(&file);
+//   r.readObject([&](const QByteArray &key) {
+//       if (key == "routes")
+//           return r.readArray([&]() { return readRoute(r); });
+//       return r.skipValue();
+//   });
+// Valores de tipo inesperado valem como os defaults de QJsonValue
+// (0, "", false), como na leitura por DOM.
+class JsonStreamReader
+{
+public:
+    enum Token {
+        BeginObject, EndObject, BeginArray, EndArray,
+        Key, String, Number, Bool, Null,
+        EndOfInput, Invalid
+    };
+
+    explicit JsonStreamReader(QIODevice *device);
+
+    // próximo token; Invalid em erro de sintaxe (ver errorString)
+    Token next();
+    // devolve o último token para o próximo next()
+    void unread() { m_pushedBack = true; }
+
+    // texto do último Key/String (UTF-8, já sem escapes) ou Number
+    const QByteArray &text() const { return m_text; }
+    bool boolean() const { return m_bool; }
+
+    // leem o próximo valor inteiro; false só em erro de sintaxe
+    bool readInt(int &v);
+    bool readDouble(double &v);
+    bool readString(QString &v);
+    bool skipValue();
+
+    // objeto: field(key) para cada chave, que deve consumir o valor
+    bool readObject(const std::function<bool(const QByteArray &key)> &field);
+    // array: item() para cada elemento, que deve consumir o valor
+    bool readArray(const std::function<bool()> &item);
+
+    bool hasError() const { return !m_error.isEmpty(); }
+    QString errorString() const { return m_error; }
+    qint64 bytesRead() const { return m_consumed + m_pos; }
+
+private:
+    QIODevice *m_dev;
+    QByteArray m_buf;
+    int m_pos = 0;
+    qint64 m_consumed = 0;    // bytes dos blocos anteriores
+
+    QVector<char> m_stack;    // '{' ou '[' abertos
+    bool m_expectKey  = false;
+    bool m_afterValue = false;
+    bool m_afterComma = false;
+    bool m_rootDone   = false;
+    bool m_pushedBack = false;
+    Token m_token = Invalid;
+    QByteArray m_text;
+    bool m_bool = false;
+    QString m_error;
+
+    bool fill();
+    int peekChar()
+    {
+        if (m_pos >= m_buf.size() && !fill())
+            return -1;
+        return (unsigned char)m_buf.at(m_pos);
+    }
+    void skipWhitespace();
+    bool readStringBody();
+    bool readNumber();
+    bool readLiteral(const char *word);
+    Token fail(const QString &msg);
+};
+
+#endif // GAJSONSTREAM_H
@@ -0,0 +1,166 @@
+// gamarginal.cpp
+#include "gamarginal.h"
+
+#include <QHash>
+#include <QJsonArray>
+#include <QRunnable>
+#include <QThread>
+#include <QThreadPool>
+
+#include <algorithm>
+#include <numeric>
+
+namespace {
+
+// itens por tarefa do pool
+constexpr int ItemChunk = 16;
+
+// f(i) para i em [0, n), em faixas de ItemChunk no pool
+template <class F>
+void parallelFor(int n, int threads, F f)
+{
+    QThreadPool pool;
+    pool.setMaxThreadCount(threads > 0 ? threads : QThread::idealThreadCount());
+    for (int first = 0; first < n; first += ItemChunk) {
+        pool.start(QRunnable::create([&f, first, n]() {
+            const int last = qMin(n, first + ItemChunk);
+            for (int i = first; i < last; ++i)
+                f(i);
+        }));
+    }
+    pool.waitForDone();
+}
+
+struct Delta {
+    double score = 0.0;
+    int served = 0;
+    long long travel = 0;
+};
+
+} // namespace
+
+QJsonObject marginalValueReport(const GAEngine &engine, const GAResult &result,
+                                const MarginalOptions &opt)
+{
+    const ScenarioPtr data = engine.scenario();
+    const QVector<FlightInstance> &flights = result.bestFlights;
+    const int F = flights.size();
+    QJsonObject root;
+    if (F == 0)
+        return root;
+
+    // 1) remoção: malha fixa, só reroteamento
+    EvalStats base;
+    const double baseScore = engine.evaluateRouting(flights, engine.odDemand().constData(), base);
+    QVector<Delta> removal(F);
+    Delta *removalData = removal.data();
+    parallelFor(F, opt.threads, [&](int i) {
+        QVector<FlightInstance> without = flights;
+        without.remove(i);
+        EvalStats s;
+        const double sc = engine.evaluateRouting(without, engine.odDemand().constData(), s);
+        removalData[i] = { sc - baseScore, s.servedTotal - base.servedTotal,
+                           s.totalTravelTime - base.totalTravelTime };
+    });
+
+    QVector<int> order(F);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(),
+              [&](int a, int b) { return removal[a].score < removal[b].score; });
+    QJsonArray flightsArr;
+    for (int i : order) {
+        const FlightInstance &f = flights[i];
+        QJsonObject o;
+        o["flight_index"]       = i;
+        o["tmpl_id"]            = f.tmplId;
+        o["orig_id"]            = f.orig;
+        o["dest_id"]            = f.dest;
+        o["dep_min"]            = f.depMin;
+        o["arr_min"]            = f.arrMin;
+        o["aircraft_id"]        = data->fleet.aircraftIds.value(f.aircraftIdx);
+        o["used_seats"]         = f.usedSeats;
+        o["delta_score"]        = removal[i].score;
+        o["delta_served"]       = removal[i].served;
+        o["delta_travel_time_min"] = (double)removal[i].travel;
+        flightsArr.append(o);
+    }
+
+    // 2) acréscimo: genes da melhor solução + um template inativo
+    QVector<int> genes;
+    genes.reserve(F);
+    for (const FlightInstance &f : flights)
+        genes.append(f.tmplId);
+    std::sort(genes.begin(), genes.end());
+    QVector<char> active(data->allFlights.size(), 0);
+    for (int g : genes)
+        active[g] = 1;
+
+    // demanda não atendida por par OD -> aeroportos com sobra de demanda
+    QHash<quint64, long long> served;
+    for (const QVariantMap &rec : result.bestPaxAssignments)
+        served[GAEngine::odKey(rec.value("orig_id").toInt(), rec.value("dest_id").toInt())]
+            += rec.value("pax").toInt();
+    const int A = data->airports.size();
+    QVector<char> origOpen(A, 0), destOpen(A, 0);
+    const QVector<int> &odDemand = engine.odDemand();
+    for (int i = 0; i < data->od.size(); ++i) {
+        const ODDemand &d = data->od[i];
+        const long long demand = (long long)odDemand[i] * data->params.numDays;
+        if (demand > served.value(GAEngine::odKey(d.orig, d.dest))) {
+            origOpen[d.orig] = 1;
+            destOpen[d.dest] = 1;
+        }
+    }
+    QVector<int> candidates;
+    for (const FlightTemplate &ft : data->allFlights)
+        if (!active[ft.id] && (origOpen[ft.orig] || destOpen[ft.dest]))
+            candidates.append(ft.id);
+
+    EvalStats kernelBase;
+    QVector<FlightInstance> flTmp;
+    QVector<QVariantMap> paxTmp;
+    const double kernelBaseScore = engine.evaluateChromosome(genes, kernelBase, flTmp, paxTmp);
+    QVector<Delta> addition(candidates.size());
+    Delta *additionData = addition.data();
+    parallelFor(candidates.size(), opt.threads, [&](int k) {
+        const int g = candidates[k];
+        QVector<int> with = genes;
+        with.insert(std::lower_bound(with.begin(), with.end(), g) - with.begin(), g);
+        EvalStats s;
+        QVector<FlightInstance> fl;
+        QVector<QVariantMap> pax;
+        const double sc = engine.evaluateChromosome(with, s, fl, pax);
+        additionData[k] = { sc - kernelBaseScore, s.servedTotal - kernelBase.servedTotal,
+                            s.totalTravelTime - kernelBase.totalTravelTime };
+    });
+
+    QVector<int> addOrder(candidates.size());
+    std::iota(addOrder.begin(), addOrder.end(), 0);
+    std::sort(addOrder.begin(), addOrder.end(),
+              [&](int a, int b) { return addition[a].score > addition[b].score; });
+    QJsonArray addArr;
+    for (int k : addOrder) {
+        if (addArr.size() >= opt.topAdditions || addition[k].score <= 0.0)
+            break;
+        const FlightTemplate &ft = data->allFlights[candidates[k]];
+        QJsonObject o;
+        o["tmpl_id"]      = ft.id;
+        o["orig_id"]      = ft.orig;
+        o["dest_id"]      = ft.dest;
+        o["dep_min"]      = ft.depMin;
+        o["arr_min"]      = ft.arrMin;
+        if (!data->fleet.types[ft.typeIdx].name.isEmpty())
+            o["aircraft_type"] = data->fleet.types[ft.typeIdx].name;
+        o["delta_score"]  = addition[k].score;
+        o["delta_served"] = addition[k].served;
+        o["delta_travel_time_min"] = (double)addition[k].travel;
+        addArr.append(o);
+    }
+
+    root["base_score_fixed_schedule"] = baseScore;
+    root["base_score"]                = kernelBaseScore;
+    root["removal"]                   = flightsArr;
+    root["candidates_evaluated"]      = candidates.size();
+    root["additions"]                 = addArr;
+    return root;
+}
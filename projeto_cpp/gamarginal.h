@@ -0,0 +1,27 @@
+// gamarginal.h
+#ifndef GAMARGINAL_H
+#define GAMARGINAL_H
+
+#include "gaengine.h"
+
+#include <QJsonObject>
+
+// Valor marginal de cada voo da melhor solução ("o que perdemos se
+// cancelarmos este voo?") e dos templates inativos que mais valeria
+// acrescentar (marginal_value.json).
+//
+// Remoção: a malha e as aeronaves ficam como estão e só os passageiros
+// são reroteados sem o voo (GAEngine::evaluateRouting), comparado com a
+// mesma malha completa. Acréscimo: o cromossomo da melhor solução mais o
+// gene passa pelo kernel completo (aeronaves realocadas); só entram
+// templates que saem da origem ou chegam ao destino de um par OD com
+// demanda não atendida. As duas passadas rodam em paralelo por voo.
+struct MarginalOptions {
+    int topAdditions = 50;   // templates inativos listados
+    int threads      = 0;    // 0 = núcleos da máquina
+};
+
+QJsonObject marginalValueReport(const GAEngine &engine, const GAResult &result,
+                                const MarginalOptions &opt = MarginalOptions());
+
+#endif // GAMARGINAL_H
@@ -0,0 +1,273 @@
+// gametrics.cpp
+#include "gametrics.h"
+
+#include <QDateTime>
+#include <QFile>
+#include <QHostAddress>
+#include <QMutexLocker>
+#include <QTcpServer>
+#include <QTcpSocket>
+
+#include <functional>
+
+#ifdef Q_OS_WIN
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <psapi.h>
+#elif defined(Q_OS_UNIX)
+#include <unistd.h>
+#endif
+
+void GAMetrics::runStarted(int population, int generations)
+{
+    m_population.store(population);
+    m_generations.store(generations);
+    m_generation.store(0);
+    m_evaluations.store(0);
+    m_breedSecTotal.store(0.0);
+    m_evalSecTotal.store(0.0);
+    m_lastProgressMs.store(QDateTime::currentMSecsSinceEpoch());
+    m_running.store(1);
+}
+
+void GAMetrics::generationDone(int gen, double best, double avg, int evaluations,
+                               qint64 breedUs, qint64 evalUs)
+{
+    const double breedSec = breedUs / 1e6;
+    const double evalSec  = evalUs / 1e6;
+    m_generation.store(gen);
+    m_bestScore.store(best);
+    m_avgScore.store(avg);
+    m_breedSec.store(breedSec);
+    m_evalSec.store(evalSec);
+    m_breedSecTotal.store(m_breedSecTotal.load() + breedSec);
+    m_evalSecTotal.store(m_evalSecTotal.load() + evalSec);
+    m_evalsPerSec.store(evalSec > 0.0 ? evaluations / evalSec : 0.0);
+    m_evaluations.store(m_evaluations.load() + evaluations);
+    m_lastProgressMs.store(QDateTime::currentMSecsSinceEpoch());
+}
+
+void GAMetrics::runFinished()
+{
+    m_running.store(0);
+}
+
+GAMetrics::Snapshot GAMetrics::snapshot() const
+{
+    Snapshot s;
+    s.running        = m_running.load();
+    s.generation     = m_generation.load();
+    s.generations    = m_generations.load();
+    s.population     = m_population.load();
+    s.bestScore      = m_bestScore.load();
+    s.avgScore       = m_avgScore.load();
+    s.evalsPerSec    = m_evalsPerSec.load();
+    s.breedSec       = m_breedSec.load();
+    s.evalSec        = m_evalSec.load();
+    s.breedSecTotal  = m_breedSecTotal.load();
+    s.evalSecTotal   = m_evalSecTotal.load();
+    s.evaluations    = m_evaluations.load();
+    s.lastProgressMs = m_lastProgressMs.load();
+    return s;
+}
+
+MetricsServer::MetricsServer(quint16 port, QObject *parent)
+    : QThread(parent)
+    , m_port(port)
+{
+}
+
+MetricsServer::~MetricsServer()
+{
+    stopServer();
+}
+
+bool MetricsServer::startServer(QString &error)
+{
+    if (isRunning())
+        return true;
+    m_listenOk = false;
+    start();
+    m_ready.acquire();
+    if (!m_listenOk) {
+        wait();
+        error = m_listenError;
+        return false;
+    }
+    return true;
+}
+
+void MetricsServer::stopServer()
+{
+    if (!isRunning())
+        return;
+    quit();
+    wait();
+}
+
+void MetricsServer::addRun(const QString &run, const QSharedPointer<const GAMetrics> &metrics)
+{
+    QMutexLocker lock(&m_mutex);
+    for (auto &entry : m_runs) {
+        if (entry.first == run) {
+            entry.second = metrics;
+            return;
+        }
+    }
+    m_runs.append(qMakePair(run, metrics));
+}
+
+void MetricsServer::clearRuns()
+{
+    QMutexLocker lock(&m_mutex);
+    m_runs.clear();
+}
+
+QByteArray MetricsServer::exposition() const
+{
+    QVector<QPair<QString, GAMetrics::Snapshot>> snaps;
+    {
+        QMutexLocker lock(&m_mutex);
+        for (const auto &entry : m_runs)
+            snaps.append(qMakePair(entry.first, entry.second->snapshot()));
+    }
+    const double nowSec = QDateTime::currentMSecsSinceEpoch() / 1000.0;
+
+    QByteArray out;
+    auto family = [&](const char *name, const char *type, const char *help,
+                      const std::function<double(const GAMetrics::Snapshot &)> &value) {
+        out += QByteArray("# HELP ") + name + ' ' + help + '\n';
+        out += QByteArray("# TYPE ") + name + ' ' + type + '\n';
+        for (const auto &sn : snaps) {
+            QString run = sn.first;
+            run.replace('\\', "\\\\").replace('"', "\\\"").replace('\n', "\\n");
+            out += QByteArray(name) + "{run=\"" + run.toUtf8() + "\"} "
+                   + QByteArray::number(value(sn.second), 'g', 15) + '\n';
+        }
+    };
+    using S = GAMetrics::Snapshot;
+    family("ga_running", "gauge", "1 while the run is in progress.",
+           [](const S &s) { return (double)s.running; });
+    family("ga_generation", "gauge", "Last completed generation.",
+           [](const S &s) { return (double)s.generation; });
+    family("ga_generations_target", "gauge", "Requested number of generations.",
+           [](const S &s) { return (double)s.generations; });
+    family("ga_population", "gauge", "Population size.",
+           [](const S &s) { return (double)s.population; });
+    family("ga_best_score", "gauge", "Best score found so far.",
+           [](const S &s) { return s.bestScore; });
+    family("ga_avg_score", "gauge", "Average score of the last generation.",
+           [](const S &s) { return s.avgScore; });
+    family("ga_evaluations_total", "counter", "Full chromosome evaluations.",
+           [](const S &s) { return (double)s.evaluations; });
+    family("ga_evaluations_per_second", "gauge", "Evaluation throughput in the last generation.",
+           [](const S &s) { return s.evalsPerSec; });
+    family("ga_breed_seconds", "gauge", "Breeding (selection, crossover, mutation, screening) time of the last generation.",
+           [](const S &s) { return s.breedSec; });
+    family("ga_evaluate_seconds", "gauge", "Evaluation time of the last generation.",
+           [](const S &s) { return s.evalSec; });
+    family("ga_breed_seconds_total", "counter", "Total breeding time.",
+           [](const S &s) { return s.breedSecTotal; });
+    family("ga_evaluate_seconds_total", "counter", "Total evaluation time.",
+           [](const S &s) { return s.evalSecTotal; });
+    family("ga_last_progress_timestamp_seconds", "gauge", "Unix time of the last completed generation.",
+           [](const S &s) { return s.lastProgressMs / 1000.0; });
+    family("ga_seconds_since_progress", "gauge", "Seconds since the last completed generation (0 when idle).",
+           [nowSec](const S &s) { return s.running ? nowSec - s.lastProgressMs / 1000.0 : 0.0; });
+
+    out += "# HELP process_resident_memory_bytes Resident memory size in bytes.\n";
+    out += "# TYPE process_resident_memory_bytes gauge\n";
+    out += "process_resident_memory_bytes " + QByteArray::number(residentMemoryBytes()) + '\n';
+    return out;
+}
+
+void MetricsServer::run()
+{
+    QTcpServer server;
+    if (!server.listen(QHostAddress::LocalHost, m_port)) {
+        m_listenError = QString("Metrics endpoint: cannot listen on 127.0.0.1:%1 (%2)")
+                            .arg(m_port).arg(server.errorString());
+        m_listenOk = false;
+        m_ready.release();
+        return;
+    }
+    m_listenOk = true;
+    m_ready.release();
+
+    QObject::connect(&server, &QTcpServer::newConnection, &server, [this, &server]() {
+        while (QTcpSocket *sock = server.nextPendingConnection()) {
+            QObject::connect(sock, &QTcpSocket::disconnected, sock, &QObject::deleteLater);
+            QObject::connect(sock, &QTcpSocket::readyRead, sock, [this, sock]() {
+                // só a linha de requisição importa; responde uma vez e fecha
+                if (sock->property("answered").toBool() || !sock->canReadLine())
+                    return;
+                sock->setProperty("answered", true);
+                const QList<QByteArray> req = sock->readLine().trimmed().split(' ');
+                sock->readAll();
+
+                QByteArray status = "200 OK";
+                QByteArray body;
+                if (req.size() < 2 || req[0] != "GET") {
+                    status = "405 Method Not Allowed";
+                } else if (req[1] == "/metrics") {
+                    body = exposition();
+                } else if (req[1] == "/") {
+                    body = "GA metrics endpoint: GET /metrics\n";
+                } else {
+                    status = "404 Not Found";
+                }
+                QByteArray resp = "HTTP/1.1 " + status + "\r\n"
+                                  "Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n"
+                                  "Content-Length: " + QByteArray::number(body.size()) + "\r\n"
+                                  "Connection: close\r\n\r\n" + body;
+                sock->write(resp);
+                sock->disconnectFromHost();
+            });
+        }
+    });
+
+    exec();
+}
+
+qint64 residentMemoryBytes()
+{
+#ifdef Q_OS_WIN
+    PROCESS_MEMORY_COUNTERS pmc;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc)))
+        return (qint64)pmc.WorkingSetSize;
+    return 0;
+#elif defined(Q_OS_LINUX)
+    QFile f("/proc/self/statm");
+    if (!f.open(QIODevice::ReadOnly))
+        return 0;
+    const QList<QByteArray> fields = f.readAll().split(' ');
+    if (fields.size() < 2)
+        return 0;
+    return fields[1].toLongLong() * sysconf(_SC_PAGESIZE);
+#else
+    return 0;
+#endif
+}
+
+qint64 peakResidentMemoryBytes()
+{
+#ifdef Q_OS_WIN
+    PROCESS_MEMORY_COUNTERS pmc;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc)))
+        return (qint64)pmc.PeakWorkingSetSize;
+    return 0;
+#elif defined(Q_OS_LINUX)
+    QFile f("/proc/self/status");
+    if (!f.open(QIODevice::ReadOnly))
+        return 0;
+    for (const QByteArray &line : f.readAll().split('\n')) {
+        if (line.startsWith("VmHWM:"))
+            return line.mid(6).trimmed().split(' ').value(0).toLongLong() * 1024;
+    }
+    return 0;
+#else
+    return 0;
+#endif
+}
@@ -0,0 +1,88 @@
+// gametrics.h
+#ifndef GAMETRICS_H
+#define GAMETRICS_H
+
+#include <QByteArray>
+#include <QMutex>
+#include <QPair>
+#include <QSemaphore>
+#include <QSharedPointer>
+#include <QString>
+#include <QThread>
+#include <QVector>
+
+#include <atomic>
+
+// Telemetria de uma execução do GA. Só o engine escreve (uma thread);
+// o MetricsServer lê a qualquer momento, por isso tudo é atômico.
+class GAMetrics
+{
+public:
+    void runStarted(int population, int generations);
+    // best = melhor score da execução até aqui; tempos em microssegundos
+    void generationDone(int gen, double best, double avg, int evaluations,
+                        qint64 breedUs, qint64 evalUs);
+    void runFinished();
+
+    struct Snapshot {
+        int running, generation, generations, population;
+        double bestScore, avgScore, evalsPerSec;
+        double breedSec, evalSec, breedSecTotal, evalSecTotal;
+        qint64 evaluations, lastProgressMs;
+    };
+    Snapshot snapshot() const;
+
+private:
+    std::atomic<int>    m_running{0};
+    std::atomic<int>    m_generation{0};
+    std::atomic<int>    m_generations{0};
+    std::atomic<int>    m_population{0};
+    std::atomic<double> m_bestScore{0.0};
+    std::atomic<double> m_avgScore{0.0};
+    std::atomic<double> m_evalsPerSec{0.0};
+    std::atomic<double> m_breedSec{0.0};     // última geração
+    std::atomic<double> m_evalSec{0.0};
+    std::atomic<double> m_breedSecTotal{0.0};
+    std::atomic<double> m_evalSecTotal{0.0};
+    std::atomic<qint64> m_evaluations{0};
+    std::atomic<qint64> m_lastProgressMs{0};  // epoch ms do último avanço
+};
+
+// Endpoint HTTP local (127.0.0.1) com GET /metrics em texto Prometheus.
+// Roda na sua própria thread com event loop, então responde mesmo com a
+// GUI ou o modo headless ocupados dentro de uma geração.
+class MetricsServer : public QThread
+{
+public:
+    explicit MetricsServer(quint16 port, QObject *parent = nullptr);
+    ~MetricsServer() override;
+
+    // sobe o servidor e espera o listen; false (e error) se a porta falhar
+    bool startServer(QString &error);
+    quint16 port() const { return m_port; }
+    void stopServer();
+
+    void addRun(const QString &run, const QSharedPointer<const GAMetrics> &metrics);
+    void clearRuns();
+
+    QByteArray exposition() const;
+
+protected:
+    void run() override;
+
+private:
+    quint16 m_port;
+    QString m_listenError;
+    bool m_listenOk = false;
+    QSemaphore m_ready;  // liberado depois do listen (ok ou erro)
+
+    mutable QMutex m_mutex;
+    QVector<QPair<QString, QSharedPointer<const GAMetrics>>> m_runs;
+};
+
+// memória residente do processo em bytes (0 se indisponível)
+qint64 residentMemoryBytes();
+// pico da memória residente desde o início do processo (0 se indisponível)
+qint64 peakResidentMemoryBytes();
+
+#endif // GAMETRICS_H
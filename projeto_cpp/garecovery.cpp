@@ -0,0 +1,323 @@
+// garecovery.cpp
+#include "garecovery.h"
+#include "gacli.h"
+#include "gaengine.h"
+
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QSet>
+#include <QTextStream>
+#include <climits>
+
+// Formato do recovery.json (caminhos relativos ao próprio arquivo):
+// {
+//   "base_dir": "airnet_inputs",       // airports/routes/passengers/fleet/forbidden
+//   "plan": "flights_ga.json",         // plano em operação
+//   "output_dir": "recovery_out",
+//   "now_min": 720,                    // voos com partida antes disso já saíram
+//   "time_budget_sec": 10, "generations": 500, "population": 60,
+//   "scope": "affected",               // ou "future": todos os voos ainda não decolados
+//   "aircraft_unavailable": [ { "aircraft_id": "AC03", "from_min": 760 } ],
+//   "airport_closures": [ { "airport_id": 2, "from_min": 780, "to_min": 900 } ]
+// }
+// Voo afetado = partida ou chegada num aeroporto fechado dentro da janela
+// (proibido) ou voo do plano que deixa de ter aeronave. Com scope
+// "affected" só os genes que tocam os aeroportos desses voos (e os
+// fechados) ficam livres; os demais repetem o plano.
+
+namespace {
+
+struct Closure {
+    int airport;
+    int fromMin;
+    int toMin;
+};
+
+// voo identificado como no warm start: (orig, dest, partida, tipo)
+struct PlanFlight {
+    int orig;
+    int dest;
+    int depMin;
+    int arrMin;
+    QString type;
+    QString aircraft;
+};
+
+QString flightKey(int orig, int dest, int dep, const QString &type)
+{
+    return QString("%1-%2-%3-%4").arg(orig).arg(dest).arg(dep).arg(type);
+}
+
+QJsonObject flightJson(const PlanFlight &f)
+{
+    QJsonObject o;
+    o["orig_id"] = f.orig;
+    o["dest_id"] = f.dest;
+    o["dep_min"] = f.depMin;
+    o["arr_min"] = f.arrMin;
+    if (!f.type.isEmpty())
+        o["aircraft_type"] = f.type;
+    o["aircraft_id"] = f.aircraft;
+    return o;
+}
+
+QVector<PlanFlight> planFlights(const QJsonArray &arr)
+{
+    QVector<PlanFlight> out;
+    for (const QJsonValue &v : arr) {
+        const QJsonObject o = v.toObject();
+        out.append({ o.value("orig_id").toInt(-1), o.value("dest_id").toInt(-1),
+                     o.value("dep_min").toInt(-1), o.value("arr_min").toInt(-1),
+                     o.value("aircraft_type").toString(), o.value("aircraft_id").toString() });
+    }
+    return out;
+}
+
+QJsonObject scoreJson(double score, const EvalStats &s)
+{
+    QJsonObject o;
+    o["score"]         = score;
+    o["served_total"]  = s.servedTotal;
+    o["unserved"]      = s.unserved;
+    o["num_flights"]   = s.numFlights;
+    o["used_aircraft"] = s.usedAircraft;
+    return o;
+}
+
+} // namespace
+
+int runRecovery(const QStringList &args)
+{
+    QTextStream out(stdout);
+
+    const QString cfgPath = argValue(args, "--recover", QString());
+    QFile cf(cfgPath);
+    if (cfgPath.isEmpty() || !cf.open(QIODevice::ReadOnly)) {
+        out << "[recover] cannot open recovery file: " << cfgPath << "\n";
+        return 1;
+    }
+    QJsonParseError pe;
+    const QJsonDocument cfgDoc = QJsonDocument::fromJson(cf.readAll(), &pe);
+    cf.close();
+    if (pe.error != QJsonParseError::NoError) {
+        out << "[recover] JSON parse error in " << cfgPath << ": " << pe.errorString() << "\n";
+        return 1;
+    }
+
+    const QJsonObject cfg = cfgDoc.object();
+    const QDir cfgDir = QFileInfo(cfgPath).absoluteDir();
+    const QDir baseDir(cfgDir.absoluteFilePath(cfg.value("base_dir").toString(".")));
+    const QDir outDir(cfgDir.absoluteFilePath(cfg.value("output_dir").toString("recovery_out")));
+    const QString planPath = cfgDir.absoluteFilePath(cfg.value("plan").toString("flights_ga.json"));
+    const int nowMin      = cfg.value("now_min").toInt(0);
+    const double budget   = cfg.value("time_budget_sec").toDouble(10.0);
+    const int population  = cfg.value("population").toInt(60);
+    const int generations = cfg.value("generations").toInt(500);
+    const bool onlyAffected = cfg.value("scope").toString("affected") != "future";
+
+    QElapsedTimer total;
+    total.start();
+
+    QString err;
+    ScenarioPtr data = GAEngine::loadScenario(baseDir.filePath("airports.json"),
+                                              baseDir.filePath("routes.json"),
+                                              baseDir.filePath("passengers.json"),
+                                              baseDir.filePath("fleet.json"),
+                                              baseDir.filePath("forbidden_routes.json"),
+                                              err);
+    if (!data) {
+        out << "[recover] " << err << "\n";
+        return 1;
+    }
+    GAEngine engine;
+    engine.setScenario(data);
+    if (!engine.loadWarmStart(planPath, err)) {
+        out << "[recover] " << err << "\n";
+        return 1;
+    }
+    QFile pf(planPath);
+    if (!pf.open(QIODevice::ReadOnly)) {
+        out << "[recover] cannot open plan: " << planPath << "\n";
+        return 1;
+    }
+    const QJsonDocument planDoc = QJsonDocument::fromJson(pf.readAll(), &pe);
+    pf.close();
+    if (pe.error != QJsonParseError::NoError) {
+        out << "[recover] JSON parse error in " << planPath << ": " << pe.errorString() << "\n";
+        return 1;
+    }
+    const QVector<PlanFlight> plan = planFlights(planDoc.object().value("flights").toArray());
+
+    // disrupção
+    const QVector<FlightTemplate> &all = data->allFlights;
+    QVector<int> groundedFrom(data->fleet.numAircraft, INT_MAX);
+    for (const QJsonValue &v : cfg.value("aircraft_unavailable").toArray()) {
+        const QJsonObject o = v.toObject();
+        const QString id = o.value("aircraft_id").toString();
+        const int idx = data->fleet.aircraftIds.indexOf(id);
+        if (idx < 0) {
+            out << "[recover] unknown aircraft_id: " << id << "\n";
+            return 1;
+        }
+        groundedFrom[idx] = qMin(groundedFrom[idx], o.value("from_min").toInt(nowMin));
+    }
+    QVector<Closure> closures;
+    for (const QJsonValue &v : cfg.value("airport_closures").toArray()) {
+        const QJsonObject o = v.toObject();
+        closures.append({ o.value("airport_id").toInt(-1),
+                          o.value("from_min").toInt(nowMin),
+                          o.value("to_min").toInt(INT_MAX) });
+    }
+    QVector<int> blocked;
+    QSet<int> affectedAirports;
+    for (const Closure &c : closures) {
+        affectedAirports.insert(c.airport);
+        for (const FlightTemplate &ft : all) {
+            const bool depHit = ft.orig == c.airport && ft.depMin >= c.fromMin && ft.depMin < c.toMin;
+            const bool arrHit = ft.dest == c.airport && ft.arrMin >= c.fromMin && ft.arrMin < c.toMin;
+            if ((depHit || arrHit) && ft.depMin >= nowMin)
+                blocked.append(ft.id);
+        }
+    }
+
+    // plano original, sem e com a disrupção (nada replanejado)
+    const QVector<int> &planGenes = engine.warmStartGenes();
+    EvalStats baseStats, keepStats;
+    QVector<FlightInstance> flights;
+    QVector<QVariantMap> pax;
+    const double baseScore = engine.evaluateChromosome(planGenes, baseStats, flights, pax);
+
+    engine.blockGenes(blocked);
+    engine.setAircraftGroundedFrom(groundedFrom);
+    QVector<int> dropped;
+    const double keepScore = engine.evaluateChromosome(planGenes, keepStats, flights, pax, &dropped);
+    for (int g : dropped) {
+        affectedAirports.insert(all[g].orig);
+        affectedAirports.insert(all[g].dest);
+    }
+
+    // genes fixos: já decolados e fora da área afetada repetem o plano
+    QVector<char> inPlan(all.size(), 0);
+    for (int g : planGenes) inPlan[g] = 1;
+    QVector<int> forcedOn, forcedOff = blocked;
+    for (const FlightTemplate &ft : all) {
+        const bool departed = ft.depMin < nowMin;
+        const bool outside = onlyAffected && !affectedAirports.contains(ft.orig)
+                             && !affectedAirports.contains(ft.dest);
+        if (departed || outside)
+            (inPlan[ft.id] ? forcedOn : forcedOff).append(ft.id);
+    }
+    engine.setFrozenGenes(forcedOn, forcedOff);
+    engine.setTimeBudgetMs(qint64(budget * 1000.0));
+
+    out << "[recover] plan: " << planGenes.size() << " flights | blocked: " << blocked.size()
+        << " | dropped by disruption: " << dropped.size()
+        << " | affected airports: " << affectedAirports.size()
+        << " | free genes: " << engine.freeGenes() << " / " << all.size() << "\n";
+    out.flush();
+
+    GAResult res = engine.runGA(population, generations);
+
+    // mudanças em relação ao plano
+    QHash<QString, int> planByKey;
+    for (int i = 0; i < plan.size(); ++i)
+        planByKey.insert(flightKey(plan[i].orig, plan[i].dest, plan[i].depMin, plan[i].type), i);
+    QVector<PlanFlight> now;
+    for (const FlightInstance &f : res.bestFlights) {
+        if (f.aircraftIdx < 0) continue;
+        now.append({ f.orig, f.dest, f.depMin, f.arrMin, data->fleet.types[f.typeIdx].name,
+                     data->fleet.aircraftIds.value(f.aircraftIdx) });
+    }
+    QVector<char> planMatched(plan.size(), 0);
+    QVector<int> added;
+    QJsonArray kept, aircraftChanged;
+    for (int i = 0; i < now.size(); ++i) {
+        const int p = planByKey.value(flightKey(now[i].orig, now[i].dest, now[i].depMin, now[i].type), -1);
+        if (p < 0) {
+            added.append(i);
+            continue;
+        }
+        planMatched[p] = 1;
+        kept.append(flightJson(now[i]));
+        if (plan[p].aircraft != now[i].aircraft) {
+            QJsonObject o = flightJson(now[i]);
+            o["old_aircraft_id"] = plan[p].aircraft;
+            aircraftChanged.append(o);
+        }
+    }
+    // cancelado + novo na mesma ligação e tipo = retime (o mais próximo)
+    QJsonArray cancelled, retimed, addedArr;
+    QVector<char> addedUsed(added.size(), 0);
+    for (int p = 0; p < plan.size(); ++p) {
+        if (planMatched[p]) continue;
+        int best = -1;
+        for (int k = 0; k < added.size(); ++k) {
+            const PlanFlight &a = now[added[k]];
+            if (addedUsed[k] || a.orig != plan[p].orig || a.dest != plan[p].dest
+                || a.type != plan[p].type)
+                continue;
+            if (best < 0 || qAbs(a.depMin - plan[p].depMin)
+                                < qAbs(now[added[best]].depMin - plan[p].depMin))
+                best = k;
+        }
+        if (best < 0) {
+            cancelled.append(flightJson(plan[p]));
+            continue;
+        }
+        addedUsed[best] = 1;
+        QJsonObject o = flightJson(now[added[best]]);
+        o["old_dep_min"] = plan[p].depMin;
+        o["old_arr_min"] = plan[p].arrMin;
+        o["old_aircraft_id"] = plan[p].aircraft;
+        retimed.append(o);
+    }
+    for (int k = 0; k < added.size(); ++k)
+        if (!addedUsed[k]) addedArr.append(flightJson(now[added[k]]));
+
+    QJsonObject report;
+    report["now_min"]             = nowMin;
+    report["time_budget_sec"]     = budget;
+    report["seconds"]             = total.elapsed() / 1000.0;
+    report["generations_run"]     = res.history.size();
+    report["blocked_templates"]   = blocked.size();
+    report["free_genes"]          = engine.freeGenes();
+    report["original"]            = scoreJson(baseScore, baseStats);
+    report["disrupted_no_action"] = scoreJson(keepScore, keepStats);
+    report["recovered"]           = scoreJson(res.bestScore, res.bestStats);
+    QJsonObject changes;
+    changes["kept"]             = kept.size();
+    changes["cancelled"]        = cancelled;
+    changes["added"]            = addedArr;
+    changes["retimed"]          = retimed;
+    changes["aircraft_changed"] = aircraftChanged;
+    report["changes"] = changes;
+
+    if (!QDir().mkpath(outDir.absolutePath())) {
+        out << "[recover] cannot create output dir " << outDir.absolutePath() << "\n";
+        return 1;
+    }
+    const bool ok = writeJson(outDir.filePath("flights_ga.json"), res.fullJson)
+                    && writeJson(outDir.filePath("passengers_flights.json"), res.passengersJson)
+                    && writeJson(outDir.filePath("ga_stats.json"), res.evolutionJson)
+                    && writeJson(outDir.filePath("recovery_report.json"), QJsonDocument(report));
+
+    out << QString("[recover] score: original %1 | no action %2 | recovered %3\n")
+               .arg(baseScore, 0, 'f', 0).arg(keepScore, 0, 'f', 0).arg(res.bestScore, 0, 'f', 0);
+    out << QString("[recover] served: original %1 | no action %2 | recovered %3\n")
+               .arg(baseStats.servedTotal).arg(keepStats.servedTotal).arg(res.bestStats.servedTotal);
+    out << QString("[recover] changes: %1 kept, %2 cancelled, %3 added, %4 retimed, "
+                   "%5 aircraft swaps | %6 s\n")
+               .arg(kept.size()).arg(cancelled.size()).arg(addedArr.size())
+               .arg(retimed.size()).arg(aircraftChanged.size())
+               .arg(total.elapsed() / 1000.0, 0, 'f', 1);
+    if (!ok) {
+        out << "[recover] error writing outputs to " << outDir.absolutePath() << "\n";
+        return 1;
+    }
+    out << "[recover] report: " << outDir.filePath("recovery_report.json") << "\n";
+    return 0;
+}
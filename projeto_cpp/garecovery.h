@@ -0,0 +1,17 @@
+// garecovery.h
+#ifndef GARECOVERY_H
+#define GARECOVERY_H
+
+#include <QStringList>
+
+// Modo headless de replanejamento (irregularidades operacionais):
+//   AeroportosGA --recover <recovery.json>
+// Parte do flights_ga.json em operação e de uma descrição da disrupção
+// (aeronave indisponível a partir de um minuto, aeroporto fechado numa
+// janela). Congela os voos já decolados, proíbe os que caem no fechamento
+// e reotimiza só os genes dos aeroportos afetados em volta do plano
+// original, dentro de um orçamento de tempo. Grava as saídas usuais mais
+// recovery_report.json com as mudanças em relação ao plano.
+int runRecovery(const QStringList &args);
+
+#endif // GARECOVERY_H
@@ -0,0 +1,213 @@
+// garobust.cpp
+#include "garobust.h"
+#include "gacli.h"
+
+#include <QDir>
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QRandomGenerator>
+#include <QRunnable>
+#include <QTextStream>
+#include <QThread>
+#include <QThreadPool>
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// amostras por tarefa do pool
+constexpr int SampleChunk = 64;
+
+// média, desvio, extremos e percentis (nearest-rank) de uma coluna
+QJsonObject distribution(QVector<double> v)
+{
+    QJsonObject o;
+    if (v.isEmpty())
+        return o;
+    std::sort(v.begin(), v.end());
+    double sum = 0.0, sum2 = 0.0;
+    for (double x : v) {
+        sum  += x;
+        sum2 += x * x;
+    }
+    const double n = v.size();
+    const double mean = sum / n;
+    auto pct = [&](double q) { return v[qBound(0, int(std::ceil(q * n)) - 1, v.size() - 1)]; };
+    o["mean"] = mean;
+    o["std"]  = std::sqrt(qMax(0.0, sum2 / n - mean * mean));
+    o["min"]  = v.first();
+    o["p05"]  = pct(0.05);
+    o["p10"]  = pct(0.10);
+    o["p50"]  = pct(0.50);
+    o["p90"]  = pct(0.90);
+    o["p95"]  = pct(0.95);
+    o["max"]  = v.last();
+    return o;
+}
+
+} // namespace
+
+void sampleDemand(const GAEngine &engine, const RobustnessOptions &opt, int s,
+                  QVector<int> &out)
+{
+    const QVector<int> &nominal = engine.odDemand();
+    QRandomGenerator rng(opt.seed ^ (0x9E3779B9u * quint32(s + 1)));
+    out.resize(nominal.size());
+    for (int i = 0; i < nominal.size(); ++i) {
+        const double f = 1.0 + opt.spread * (2.0 * rng.generateDouble() - 1.0);
+        out[i] = qMax(0, int(std::lround(nominal[i] * f)));
+    }
+}
+
+QVector<QVector<int>> sampleDemandSet(const GAEngine &engine, const RobustnessOptions &opt)
+{
+    QVector<QVector<int>> set(opt.samples);
+    for (int s = 0; s < opt.samples; ++s)
+        sampleDemand(engine, opt, s, set[s]);
+    return set;
+}
+
+QJsonObject robustnessReport(const GAEngine &engine,
+                             const QVector<QVector<FlightInstance>> &schedules,
+                             const RobustnessOptions &opt)
+{
+    const int S = qMax(1, opt.samples);
+    const int threads = opt.threads > 0 ? opt.threads : QThread::idealThreadCount();
+
+    QJsonArray arr;
+    for (int k = 0; k < schedules.size(); ++k) {
+        const QVector<FlightInstance> &flights = schedules[k];
+        QVector<double> score(S), served(S), unserved(S), servedFrac(S);
+
+        // cada tarefa escreve só na sua faixa de amostras
+        double *scoreData = score.data();
+        double *servedData = served.data();
+        double *unservedData = unserved.data();
+        double *fracData = servedFrac.data();
+        QThreadPool pool;
+        pool.setMaxThreadCount(threads);
+        for (int first = 0; first < S; first += SampleChunk) {
+            pool.start(QRunnable::create([&, first]() {
+                QVector<int> demand;
+                EvalStats st;
+                const int last = qMin(S, first + SampleChunk);
+                for (int s = first; s < last; ++s) {
+                    sampleDemand(engine, opt, s, demand);
+                    scoreData[s]    = engine.evaluateRouting(flights, demand.constData(), st);
+                    servedData[s]   = st.servedTotal;
+                    unservedData[s] = st.unserved;
+                    const int total = st.servedTotal + st.unserved;
+                    fracData[s]     = total > 0 ? double(st.servedTotal) / total : 0.0;
+                }
+            }));
+        }
+        pool.waitForDone();
+
+        EvalStats nominal;
+        const double nominalScore =
+            engine.evaluateRouting(flights, engine.odDemand().constData(), nominal);
+
+        QJsonObject o;
+        o["rank"]             = k;
+        o["num_flights"]      = flights.size();
+        o["nominal_score"]    = nominalScore;
+        o["nominal_served"]   = nominal.servedTotal;
+        o["score"]            = distribution(score);
+        o["served_total"]     = distribution(served);
+        o["unserved"]         = distribution(unserved);
+        o["served_fraction"]  = distribution(servedFrac);
+        arr.append(o);
+    }
+
+    QJsonObject root;
+    root["samples"]   = S;
+    root["spread"]    = opt.spread;
+    root["seed"]      = (double)opt.seed;
+    root["schedules"] = arr;
+    return root;
+}
+
+int runRobustness(const QStringList &args)
+{
+    QTextStream out(stdout);
+
+    const QDir dir(argValue(args, "--robust", "."));
+    RobustnessOptions opt;
+    opt.samples = argValue(args, "--samples", "1000").toInt();
+    opt.spread  = argValue(args, "--spread", "0.2").toDouble();
+    opt.seed    = argValue(args, "--seed", "1").toUInt();
+    opt.threads = argValue(args, "--threads", "0").toInt();
+    const QString outPath = argValue(args, "--out", dir.filePath("robustness.json"));
+    if (opt.samples <= 0) {
+        out << "[robust] --samples must be a positive integer\n";
+        return 1;
+    }
+
+    QStringList plans;
+    for (int i = 0; i + 1 < args.size(); ++i)
+        if (args[i] == "--plan")
+            plans << args[i + 1];
+    if (plans.isEmpty())
+        plans << dir.filePath("flights_ga.json");
+
+    QString err;
+    ScenarioPtr data = GAEngine::loadScenario(dir.filePath("airports.json"),
+                                              dir.filePath("routes.json"),
+                                              dir.filePath("passengers.json"),
+                                              dir.filePath("fleet.json"),
+                                              dir.filePath("forbidden_routes.json"),
+                                              err);
+    if (!data) {
+        out << "[robust] " << err << "\n";
+        return 1;
+    }
+    GAEngine engine;
+    engine.setScenario(data);
+
+    // cada plano é reconstruído pelo kernel (mesma alocação de aeronaves)
+    QVector<QVector<FlightInstance>> schedules;
+    for (const QString &plan : plans) {
+        if (!engine.loadWarmStart(plan, err)) {
+            out << "[robust] " << err << "\n";
+            return 1;
+        }
+        EvalStats s;
+        QVector<FlightInstance> flights;
+        QVector<QVariantMap> pax;
+        engine.evaluateChromosome(engine.warmStartGenes(), s, flights, pax);
+        schedules.append(flights);
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    QJsonObject report = robustnessReport(engine, schedules, opt);
+    const double sec = timer.elapsed() / 1000.0;
+
+    QJsonArray arr = report.value("schedules").toArray();
+    for (int k = 0; k < arr.size(); ++k) {
+        QJsonObject o = arr[k].toObject();
+        o["plan"] = plans[k];
+        arr[k] = o;
+        const QJsonObject sc = o.value("score").toObject();
+        const QJsonObject sv = o.value("served_total").toObject();
+        out << QString("[robust] %1: nominal %2 | mean %3 | p05 %4 | served mean %5 (p05 %6)\n")
+                   .arg(plans[k])
+                   .arg(o.value("nominal_score").toDouble(), 0, 'f', 0)
+                   .arg(sc.value("mean").toDouble(), 0, 'f', 0)
+                   .arg(sc.value("p05").toDouble(), 0, 'f', 0)
+                   .arg(sv.value("mean").toDouble(), 0, 'f', 0)
+                   .arg(sv.value("p05").toDouble(), 0, 'f', 0);
+    }
+    report["schedules"] = arr;
+    report["seconds"]   = sec;
+
+    if (!writeJson(outPath, QJsonDocument(report))) {
+        out << "[robust] cannot write " << outPath << "\n";
+        return 1;
+    }
+    out << QString("[robust] %1 samples x %2 schedules in %3 s -> %4\n")
+               .arg(opt.samples).arg(schedules.size()).arg(sec, 0, 'f', 2).arg(outPath);
+    return 0;
+}
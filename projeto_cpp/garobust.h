@@ -0,0 +1,40 @@
+// garobust.h
+#ifndef GAROBUST_H
+#define GAROBUST_H
+
+#include "gaengine.h"
+
+#include <QJsonObject>
+#include <QStringList>
+
+// Robustez de uma malha à flutuação da demanda: a malha (voos e aeronaves)
+// fica fixa e só o roteamento de passageiros é refeito em cada amostra
+// (GAEngine::evaluateRouting). Cada par OD recebe um fator independente
+// uniforme em [1 - spread, 1 + spread] sobre a demanda nominal; a amostra
+// s depende só de (seed, s), então o resultado não depende das threads.
+struct RobustnessOptions {
+    int samples   = 1000;
+    double spread = 0.2;
+    quint32 seed  = 1;
+    int threads   = 0;     // 0 = núcleos da máquina
+};
+
+// demanda diária por par de engine.scenario()->od na amostra s
+void sampleDemand(const GAEngine &engine, const RobustnessOptions &opt, int s,
+                  QVector<int> &out);
+QVector<QVector<int>> sampleDemandSet(const GAEngine &engine, const RobustnessOptions &opt);
+
+// distribuição de score, atendidos, não atendidos e ocupação de cada malha
+// (robustness.json: "schedules", na ordem de entrada)
+QJsonObject robustnessReport(const GAEngine &engine,
+                             const QVector<QVector<FlightInstance>> &schedules,
+                             const RobustnessOptions &opt);
+
+// Modo headless:
+//   AeroportosGA --robust <dir-com-jsons> [--plan flights_ga.json]...
+//            [--samples N] [--spread 0.2] [--seed S] [--threads N]
+//            [--out robustness.json]
+// Avalia cada --plan (padrão: flights_ga.json da pasta) nas amostras.
+int runRobustness(const QStringList &args);
+
+#endif // GAROBUST_H
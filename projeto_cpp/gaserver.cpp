@@ -0,0 +1,703 @@
+// gaserver.cpp
+#include "gaserver.h"
+#include "gabatch.h"
+#include "gacli.h"
+
+#include <QCoreApplication>
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QHostAddress>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QMetaObject>
+#include <QRunnable>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTextStream>
+#include <QThread>
+
+// Corpo de POST /jobs (todos opcionais, menos o cenário):
+// {
+//   "scenario": "<hash de POST /scenarios>",   // ou "base_dir": "..."
+//   "priority": 0,                   // maior roda antes; empate = ordem de chegada
+//   "population": 60, "generations": 60, "seed": 1,
+//   "p_cross": 0.8, "p_mut": 0.01, "elite_frac": 0.1, "tournament": 2,
+//   "repair": false, "adaptive_mutation": false,
+//   "crossover": "one_point",        // ou airport_blocks / time_blocks
+//   "gap_stop": 0.0, "time_budget_sec": 0,
+//   "overlay": { "name": ..., "forbidden_od": [...], "demand_scale": 1.1, ... },
+//   "output_dir": "..."              // grava também os JSONs de saída, num
+//                                    // caminho relativo a --output-root
+// }
+
+namespace {
+
+// jobs terminados mantidos em memória (os mais antigos saem primeiro)
+constexpr int MaxFinishedJobs = 200;
+
+// cargas de cenário simultâneas, fora do pool dos jobs (que pode estar
+// cheio de GAs longos); cada carga já lê os arquivos em paralelo
+constexpr int LoadThreads = 2;
+
+// corpo de requisição aceito
+constexpr int MaxRequestBytes = 4 * 1024 * 1024;
+
+const char *const ScenarioFiles[] = {
+    "airports.json", "routes.json", "passengers.json", "fleet.json",
+    "forbidden_routes.json", "meta.json", "slots.json"
+};
+
+// hash do conteúdo de todos os arquivos que loadScenario lê (ausentes
+// também entram, como ausentes)
+QString scenarioHash(const QDir &dir)
+{
+    QCryptographicHash h(QCryptographicHash::Sha256);
+    for (const char *name : ScenarioFiles) {
+        QFile f(dir.filePath(name));
+        h.addData(QByteArray(name) + '\0');
+        if (f.open(QIODevice::ReadOnly)) {
+            const QByteArray data = f.readAll();
+            h.addData(QByteArray::number(data.size()) + '\0');
+            h.addData(data);
+        } else {
+            h.addData(QByteArray("-\0", 2));
+        }
+    }
+    return QString::fromLatin1(h.result().toHex().left(16));
+}
+
+// cabeçalho Host de quem falou com 127.0.0.1 ("127.0.0.1:8470")
+bool localHost(const QByteArray &host)
+{
+    const int colon = host.lastIndexOf(':');
+    const QByteArray name = colon >= 0 ? host.left(colon) : host;
+    return name == "127.0.0.1" || name == "localhost";
+}
+
+bool finished(const ServerJob &job)
+{
+    return job.state == "done" || job.state == "cancelled" || job.state == "failed";
+}
+
+} // namespace
+
+GAServer::GAServer(int workers, const QString &outputRoot, QObject *parent)
+    : QObject(parent)
+    , m_workers(qMax(1, workers))
+    , m_outputRoot(QDir(outputRoot).absolutePath())
+{
+    m_pool.setMaxThreadCount(m_workers);
+    m_loadPool.setMaxThreadCount(LoadThreads);
+}
+
+GAServer::~GAServer()
+{
+    for (const QSharedPointer<ServerJob> &job : m_jobs)
+        job->stop.store(true);
+    m_pool.waitForDone();
+    m_loadPool.waitForDone();
+}
+
+bool GAServer::listen(quint16 port, QString &error)
+{
+    m_server = new QTcpServer(this);
+    if (!m_server->listen(QHostAddress::LocalHost, port)) {
+        error = QString("cannot listen on 127.0.0.1:%1 (%2)").arg(port).arg(m_server->errorString());
+        return false;
+    }
+    connect(m_server, &QTcpServer::newConnection, this, [this]() {
+        while (QTcpSocket *sock = m_server->nextPendingConnection()) {
+            connect(sock, &QTcpSocket::readyRead, this, [this, sock]() { onReadyRead(sock); });
+            connect(sock, &QTcpSocket::disconnected, this, [this, sock]() {
+                m_buffers.remove(sock);
+                for (auto it = m_subscribers.begin(); it != m_subscribers.end(); ++it)
+                    it.value().removeAll(sock);
+                sock->deleteLater();
+            });
+        }
+    });
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// HTTP
+
+void GAServer::onReadyRead(QTcpSocket *sock)
+{
+    if (sock->property("handled").toBool()) {
+        sock->readAll(); // uma requisição por conexão
+        return;
+    }
+    QByteArray &buf = m_buffers[sock];
+    buf += sock->readAll();
+    const int headerEnd = buf.indexOf("\r\n\r\n");
+    if (headerEnd < 0) {
+        if (buf.size() > MaxRequestBytes)
+            replyRaw(sock, "413 Payload Too Large", "text/plain", "request too large\n");
+        return;
+    }
+
+    const QList<QByteArray> lines = buf.left(headerEnd).split('\n');
+    const QList<QByteArray> first = lines.value(0).trimmed().split(' ');
+    Request req;
+    int contentLength = 0;
+    bool lengthOk = true;
+    for (int i = 1; i < lines.size(); ++i) {
+        const QByteArray line = lines[i].trimmed();
+        const int colon = line.indexOf(':');
+        if (colon <= 0)
+            continue;
+        const QByteArray name  = line.left(colon).trimmed().toLower();
+        const QByteArray value = line.mid(colon + 1).trimmed();
+        if (name == "content-length")
+            contentLength = value.toInt(&lengthOk);
+        else if (name == "content-type")
+            req.contentType = value.toLower();
+        else if (name == "host")
+            req.host = value.toLower();
+        else if (name == "origin")
+            req.hasOrigin = true;
+    }
+    if (!lengthOk || contentLength < 0) {
+        m_buffers.remove(sock);
+        sock->setProperty("handled", true);
+        replyRaw(sock, "400 Bad Request", "text/plain", "invalid Content-Length\n");
+        return;
+    }
+    if (contentLength > MaxRequestBytes) {
+        replyRaw(sock, "413 Payload Too Large", "text/plain", "request too large\n");
+        return;
+    }
+    if (buf.size() < headerEnd + 4 + contentLength)
+        return; // corpo ainda chegando
+
+    req.method = first.value(0);
+    req.path   = first.value(1);
+    const int q = req.path.indexOf('?');
+    if (q >= 0)
+        req.path.truncate(q);
+    req.body = buf.mid(headerEnd + 4, contentLength);
+    m_buffers.remove(sock);
+    sock->setProperty("handled", true);
+    handle(sock, req);
+}
+
+void GAServer::replyRaw(QTcpSocket *sock, const QByteArray &status, const QByteArray &type,
+                        const QByteArray &body)
+{
+    sock->write("HTTP/1.1 " + status + "\r\n"
+                "Content-Type: " + type + "\r\n"
+                "Content-Length: " + QByteArray::number(body.size()) + "\r\n"
+                "Connection: close\r\n\r\n" + body);
+    sock->disconnectFromHost();
+}
+
+void GAServer::reply(QTcpSocket *sock, const QByteArray &status, const QJsonObject &body)
+{
+    replyRaw(sock, status, "application/json",
+             QJsonDocument(body).toJson(QJsonDocument::Indented));
+}
+
+void GAServer::handle(QTcpSocket *sock, const Request &req)
+{
+    const QList<QByteArray> parts = req.path.split('/'); // "", "jobs", id, sub
+    const QByteArray coll = parts.value(1);
+    const QByteArray item = parts.value(2);
+    const QByteArray sub  = parts.value(3);
+    QByteArray status = "200 OK";
+
+    auto errorReply = [&](const QByteArray &st, const QString &msg) {
+        QJsonObject o;
+        o["error"] = msg;
+        reply(sock, st, o);
+    };
+    auto parseBody = [&](QJsonObject &out) {
+        QJsonParseError pe;
+        const QJsonDocument doc = QJsonDocument::fromJson(req.body, &pe);
+        if (pe.error != QJsonParseError::NoError || !doc.isObject()) {
+            errorReply("400 Bad Request", "body must be a JSON object: " + pe.errorString());
+            return false;
+        }
+        out = doc.object();
+        return true;
+    };
+
+    // o serviço lê e grava arquivos locais: só aceita clientes locais
+    // (curl, scripts), nunca páginas abertas no navegador. Navegadores
+    // mandam Origin em requisições entre sites e não conseguem mandar
+    // POST application/json sem preflight; Host barra DNS rebinding
+    if (req.hasOrigin || !localHost(req.host))
+        return errorReply("403 Forbidden", "only local, non-browser clients are accepted");
+    if (req.method == "POST" && req.contentType.split(';').value(0).trimmed() != "application/json")
+        return errorReply("415 Unsupported Media Type", "Content-Type must be application/json");
+
+    if (req.path == "/" && req.method == "GET") {
+        replyRaw(sock, status, "text/plain",
+                 "GA scheduling service\n"
+                 "POST /scenarios, GET /scenarios, DELETE /scenarios/<hash>\n"
+                 "POST /jobs, GET /jobs, GET /jobs/<id>[/events|/result|/passengers|/stats],"
+                 " DELETE /jobs/<id>\n");
+        return;
+    }
+
+    if (coll == "scenarios") {
+        if (item.isEmpty() && req.method == "POST") {
+            QJsonObject body;
+            if (!parseBody(body)) return;
+            QString dirPath, err;
+            if (!startLoad(body.value("base_dir").toString(), dirPath, err))
+                return errorReply("400 Bad Request", err);
+            m_loads[dirPath].waiters.append(sock); // resposta em loadFinished
+        } else if (item.isEmpty() && req.method == "GET") {
+            QJsonArray arr;
+            for (auto it = m_scenarios.constBegin(); it != m_scenarios.constEnd(); ++it) {
+                QJsonObject o;
+                o["scenario"] = it.key();
+                o["base_dir"] = m_scenarioDirs.value(it.key());
+                o["genes"]    = it.value()->allFlights.size();
+                o["airports"] = it.value()->airports.size();
+                arr.append(o);
+            }
+            QJsonArray loading;
+            for (auto it = m_loads.constBegin(); it != m_loads.constEnd(); ++it)
+                loading.append(it.key());
+            QJsonObject o;
+            o["scenarios"] = arr;
+            o["loading"]   = loading;
+            reply(sock, status, o);
+        } else if (!item.isEmpty() && req.method == "DELETE") {
+            // jobs em andamento seguram o próprio ScenarioPtr
+            if (!m_scenarios.remove(QString::fromUtf8(item)))
+                return errorReply("404 Not Found", "unknown scenario");
+            m_scenarioDirs.remove(QString::fromUtf8(item));
+            reply(sock, status, QJsonObject());
+        } else {
+            errorReply("405 Method Not Allowed", "unsupported method");
+        }
+        return;
+    }
+
+    if (coll == "jobs") {
+        if (item.isEmpty() && req.method == "POST") {
+            QJsonObject body;
+            if (!parseBody(body)) return;
+            const QJsonObject out = submitJob(body, status);
+            reply(sock, status, out);
+            return;
+        }
+        if (item.isEmpty() && req.method == "GET") {
+            QJsonArray arr;
+            for (const QSharedPointer<ServerJob> &job : m_jobs)
+                arr.append(jobJson(*job));
+            QJsonObject o;
+            o["jobs"] = arr;
+            o["workers"] = m_workers;
+            o["running"] = m_running;
+            o["queued"]  = m_queue.size();
+            reply(sock, status, o);
+            return;
+        }
+        const QSharedPointer<ServerJob> job = m_jobs.value(item.toInt());
+        if (!job)
+            return errorReply("404 Not Found", "unknown job");
+        if (req.method == "DELETE" && sub.isEmpty()) {
+            cancelJob(*job);
+            reply(sock, status, jobJson(*job));
+        } else if (req.method != "GET") {
+            errorReply("405 Method Not Allowed", "unsupported method");
+        } else if (sub.isEmpty()) {
+            reply(sock, status, jobJson(*job));
+        } else if (sub == "events") {
+            subscribe(sock, *job);
+        } else if (sub == "result" || sub == "passengers" || sub == "stats") {
+            if (job->result.fullJson.isNull())
+                return errorReply("409 Conflict", "job has no result yet (state: " + job->state + ")");
+            const QJsonDocument &doc = sub == "result"     ? job->result.fullJson
+                                       : sub == "passengers" ? job->result.passengersJson
+                                                             : job->result.evolutionJson;
+            replyRaw(sock, status, "application/json", doc.toJson(QJsonDocument::Indented));
+        } else {
+            errorReply("404 Not Found", "unknown resource");
+        }
+        return;
+    }
+
+    errorReply("404 Not Found", "unknown resource");
+}
+
+// ---------------------------------------------------------------------------
+// cenários e jobs
+
+// hash e parse numa thread de carga; loadFinished (na thread principal)
+// responde a quem espera e libera os jobs em "loading". Pedidos da mesma
+// pasta durante a carga esperam pela mesma carga
+bool GAServer::startLoad(const QString &baseDir, QString &dirPath, QString &error)
+{
+    const QDir dir(baseDir);
+    if (baseDir.isEmpty() || !dir.exists()) {
+        error = "missing or invalid 'base_dir'";
+        return false;
+    }
+    dirPath = dir.absolutePath();
+    if (m_loads.contains(dirPath))
+        return true;
+    m_loads.insert(dirPath, ScenarioLoad());
+
+    const QHash<QString, ScenarioPtr> cache = m_scenarios; // cópia rasa, só leitura
+    const QString path = dirPath;
+    m_loadPool.start(QRunnable::create([this, path, cache]() {
+        QElapsedTimer timer;
+        timer.start();
+        const QDir dir(path);
+        const QString key = scenarioHash(dir);
+        ScenarioPtr data = cache.value(key);
+        const bool cached = bool(data);
+        QString err;
+        if (!data)
+            data = GAEngine::loadScenario(dir.filePath("airports.json"),
+                                          dir.filePath("routes.json"),
+                                          dir.filePath("passengers.json"),
+                                          dir.filePath("fleet.json"),
+                                          dir.filePath("forbidden_routes.json"),
+                                          err);
+        const qint64 ms = timer.elapsed();
+        QMetaObject::invokeMethod(this, [this, path, key, data, cached, err, ms]() {
+            loadFinished(path, key, data, cached, err, ms);
+        }, Qt::QueuedConnection);
+    }));
+    return true;
+}
+
+void GAServer::loadFinished(const QString &dirPath, const QString &key, ScenarioPtr data,
+                            bool cached, const QString &error, qint64 loadMs)
+{
+    const ScenarioLoad load = m_loads.take(dirPath);
+    QByteArray status = "200 OK";
+    QJsonObject out;
+    if (!data) {
+        status = "422 Unprocessable Entity";
+        out["error"] = error;
+    } else {
+        // outra carga com o mesmo conteúdo pode ter terminado antes
+        if (m_scenarios.contains(key)) {
+            data = m_scenarios.value(key);
+        } else {
+            m_scenarios.insert(key, data);
+            m_scenarioDirs.insert(key, dirPath);
+        }
+        QJsonArray files;
+        for (const InputFileStats &st : data->inputStats) {
+            QJsonObject f;
+            f["file"]     = st.file;
+            f["bytes"]    = (double)st.bytes;
+            f["parse_ms"] = st.parseMs;
+            files.append(f);
+        }
+        out["scenario"] = key;
+        out["cached"]   = cached;
+        out["genes"]    = data->allFlights.size();
+        out["files"]    = files;
+        out["load_ms"]  = (double)loadMs;
+    }
+    for (const QPointer<QTcpSocket> &sock : load.waiters)
+        if (sock)
+            reply(sock, status, out);
+
+    for (int id : load.jobs) {
+        const QSharedPointer<ServerJob> job = m_jobs.value(id);
+        if (!job || job->state != "loading")
+            continue; // cancelado durante a carga
+        if (!data) {
+            job->state      = "failed";
+            job->error      = error;
+            job->finishedMs = QDateTime::currentMSecsSinceEpoch();
+            sendEvent(id, "done", jobJson(*job), true);
+            continue;
+        }
+        job->state       = "queued";
+        job->scenarioKey = key;
+        job->scenario    = data;
+        m_queue.append(id);
+        sendEvent(id, "state", jobJson(*job), false);
+    }
+    dispatch();
+    pruneFinished();
+}
+
+QJsonObject GAServer::submitJob(const QJsonObject &req, QByteArray &status)
+{
+    GAEngine::CrossoverMode crossoverMode;
+    if (!crossoverFromString(req.value("crossover").toString("one_point"), crossoverMode)) {
+        status = "400 Bad Request";
+        QJsonObject o;
+        o["error"] = "unknown 'crossover' (one_point, airport_blocks or time_blocks)";
+        return o;
+    }
+
+    // saída só dentro de --output-root
+    QString outputDir;
+    if (req.contains("output_dir")) {
+        const QString rel = QDir::cleanPath(req.value("output_dir").toString());
+        if (rel.isEmpty() || rel == "." || rel == ".." || rel.startsWith("../")
+            || QDir::isAbsolutePath(rel) || rel.contains(':')) {
+            status = "400 Bad Request";
+            QJsonObject o;
+            o["error"] = "'output_dir' must be a relative path inside " + m_outputRoot;
+            return o;
+        }
+        outputDir = QDir(m_outputRoot).filePath(rel);
+    }
+
+    // com base_dir o job espera a carga em "loading"
+    const QString key = req.value("scenario").toString();
+    QString loadDir;
+    if (key.isEmpty() && req.contains("base_dir")) {
+        QString err;
+        if (!startLoad(req.value("base_dir").toString(), loadDir, err)) {
+            status = "400 Bad Request";
+            QJsonObject o;
+            o["error"] = err;
+            return o;
+        }
+    } else if (!m_scenarios.contains(key)) {
+        status = "404 Not Found";
+        QJsonObject o;
+        o["error"] = "unknown scenario (POST /scenarios first, or pass 'base_dir')";
+        return o;
+    }
+
+    QSharedPointer<ServerJob> job = QSharedPointer<ServerJob>::create();
+    job->id          = m_nextJobId++;
+    job->priority    = req.value("priority").toInt(0);
+    job->state       = loadDir.isEmpty() ? "queued" : "loading";
+    job->scenarioKey = key;
+    job->scenario    = m_scenarios.value(key);
+    job->request     = req;
+    job->outputDir   = outputDir;
+    job->queuedMs    = QDateTime::currentMSecsSinceEpoch();
+    m_jobs.insert(job->id, job);
+    if (loadDir.isEmpty()) {
+        m_queue.append(job->id);
+        dispatch();
+    } else {
+        m_loads[loadDir].jobs.append(job->id);
+    }
+
+    status = "201 Created";
+    return jobJson(*job);
+}
+
+QJsonObject GAServer::jobJson(const ServerJob &job) const
+{
+    QJsonObject o;
+    o["job"]         = job.id;
+    o["state"]       = job.state;
+    o["priority"]    = job.priority;
+    o["scenario"]    = job.scenarioKey;
+    o["generation"]  = job.generation;
+    o["generations"] = job.request.value("generations").toInt(60);
+    if (job.startedMs > 0)
+        o["best_score"] = job.bestScore;
+    o["queued_ms"]   = (double)job.queuedMs;
+    if (job.startedMs > 0)  o["started_ms"]  = (double)job.startedMs;
+    if (job.finishedMs > 0) o["finished_ms"] = (double)job.finishedMs;
+    if (job.state == "queued") {
+        // posição na ordem em que dispatch() vai tirar da fila
+        int ahead = 0;
+        for (int id : m_queue) {
+            const ServerJob &other = *m_jobs.value(id);
+            if (other.priority > job.priority
+                || (other.priority == job.priority && other.id < job.id))
+                ++ahead;
+        }
+        o["queue_position"] = ahead;
+    }
+    if (!job.outputDir.isEmpty())
+        o["output_dir"] = job.outputDir;
+    if (!job.error.isEmpty())
+        o["error"] = job.error;
+    if (!job.result.fullJson.isNull())
+        o["summary"] = job.result.fullJson.object().value("summary");
+    return o;
+}
+
+void GAServer::cancelJob(ServerJob &job)
+{
+    if (job.state == "queued" || job.state == "loading") {
+        m_queue.removeAll(job.id);
+        job.state = "cancelled";
+        job.finishedMs = QDateTime::currentMSecsSinceEpoch();
+        sendEvent(job.id, "done", jobJson(job), true);
+    } else if (job.state == "running") {
+        job.stop.store(true); // jobFinished marca como cancelled
+    }
+}
+
+void GAServer::subscribe(QTcpSocket *sock, ServerJob &job)
+{
+    sock->write("HTTP/1.1 200 OK\r\n"
+                "Content-Type: text/event-stream\r\n"
+                "Cache-Control: no-cache\r\n"
+                "Connection: close\r\n\r\n");
+    const QByteArray data = QJsonDocument(jobJson(job)).toJson(QJsonDocument::Compact);
+    if (finished(job)) {
+        sock->write("event: done\ndata: " + data + "\n\n");
+        sock->disconnectFromHost();
+        return;
+    }
+    sock->write("event: state\ndata: " + data + "\n\n");
+    m_subscribers[job.id].append(sock);
+}
+
+void GAServer::sendEvent(int id, const QByteArray &event, const QJsonObject &data, bool last)
+{
+    const QVector<QTcpSocket *> socks = last ? m_subscribers.take(id) : m_subscribers.value(id);
+    const QByteArray msg = "event: " + event + "\ndata: "
+                           + QJsonDocument(data).toJson(QJsonDocument::Compact) + "\n\n";
+    for (QTcpSocket *sock : socks) {
+        sock->write(msg);
+        if (last)
+            sock->disconnectFromHost();
+    }
+}
+
+// ---------------------------------------------------------------------------
+// fila e workers
+
+void GAServer::dispatch()
+{
+    while (m_running < m_workers && !m_queue.isEmpty()) {
+        int pick = 0;
+        for (int i = 1; i < m_queue.size(); ++i) {
+            const ServerJob &a = *m_jobs.value(m_queue[i]);
+            const ServerJob &b = *m_jobs.value(m_queue[pick]);
+            if (a.priority > b.priority || (a.priority == b.priority && a.id < b.id))
+                pick = i;
+        }
+        QSharedPointer<ServerJob> job = m_jobs.value(m_queue.takeAt(pick));
+        job->state     = "running";
+        job->startedMs = QDateTime::currentMSecsSinceEpoch();
+        ++m_running;
+        sendEvent(job->id, "state", jobJson(*job), false);
+        m_pool.start(QRunnable::create([this, job]() { runJob(job); }));
+    }
+}
+
+// roda numa thread do pool; o estado do job só muda na thread principal
+void GAServer::runJob(const QSharedPointer<ServerJob> &job)
+{
+    const QJsonObject &r = job->request;
+    GAEngine engine;
+    engine.setScenario(job->scenario, overlayFromJson(r.value("overlay").toObject()));
+
+    GAParams p;
+    p.pCross         = r.value("p_cross").toDouble(p.pCross);
+    p.pMut           = r.value("p_mut").toDouble(p.pMut);
+    p.eliteFrac      = r.value("elite_frac").toDouble(p.eliteFrac);
+    p.tournamentSize = r.value("tournament").toInt(p.tournamentSize);
+    engine.setGAParams(p);
+    if (r.contains("seed"))
+        engine.setSeed(quint32(r.value("seed").toInt()));
+    engine.setRepairEnabled(r.value("repair").toBool(false));
+    engine.setAdaptiveMutation(r.value("adaptive_mutation").toBool(false));
+    GAEngine::CrossoverMode crossoverMode = GAEngine::CrossoverMode::OnePoint;
+    // nome já validado em submitJob
+    crossoverFromString(r.value("crossover").toString("one_point"), crossoverMode);
+    engine.setCrossoverMode(crossoverMode);
+    engine.setGapStopThreshold(r.value("gap_stop").toDouble(0.0));
+    engine.setTimeBudgetMs(qint64(r.value("time_budget_sec").toDouble(0.0) * 1000.0));
+    engine.setStopFlag(&job->stop);
+
+    const int id = job->id;
+    GAResult res = engine.runGA(r.value("population").toInt(60), r.value("generations").toInt(60),
+                                [this, id](int gen, double best) {
+        QMetaObject::invokeMethod(this, [this, id, gen, best]() { jobProgress(id, gen, best); },
+                                  Qt::QueuedConnection);
+    });
+
+    QString error;
+    if (res.fullJson.isNull()) {
+        error = res.summaryText.trimmed();
+    } else if (!job->outputDir.isEmpty()) {
+        const QDir outDir(job->outputDir);
+        if (!QDir().mkpath(outDir.absolutePath())
+            || !writeJson(outDir.filePath("flights_ga.json"), res.fullJson)
+            || !writeJson(outDir.filePath("passengers_flights.json"), res.passengersJson)
+            || !writeJson(outDir.filePath("ga_stats.json"), res.evolutionJson))
+            error = "cannot write outputs to " + outDir.absolutePath();
+    }
+
+    QMetaObject::invokeMethod(this, [this, job, res, error]() {
+        job->result = res;
+        job->error  = error;
+        jobFinished(job->id);
+    }, Qt::QueuedConnection);
+}
+
+void GAServer::jobProgress(int id, int gen, double best)
+{
+    const QSharedPointer<ServerJob> job = m_jobs.value(id);
+    if (!job)
+        return;
+    job->generation = gen;
+    job->bestScore  = best;
+    if (m_subscribers.contains(id)) {
+        QJsonObject o;
+        o["job"]        = id;
+        o["generation"] = gen;
+        o["best_score"] = best;
+        sendEvent(id, "progress", o, false);
+    }
+}
+
+void GAServer::jobFinished(int id)
+{
+    --m_running;
+    const QSharedPointer<ServerJob> job = m_jobs.value(id);
+    if (job) {
+        job->finishedMs = QDateTime::currentMSecsSinceEpoch();
+        if (job->result.fullJson.isNull())
+            job->state = "failed";
+        else
+            job->state = job->stop.load() ? "cancelled" : "done";
+        if (job->result.bestScore > -1e9)
+            job->bestScore = job->result.bestScore;
+        sendEvent(id, "done", jobJson(*job), true);
+    }
+    dispatch();
+    pruneFinished();
+}
+
+void GAServer::pruneFinished()
+{
+    QVector<int> done;
+    for (const QSharedPointer<ServerJob> &job : m_jobs)
+        if (finished(*job))
+            done.append(job->id);
+    for (int i = 0; i < done.size() - MaxFinishedJobs; ++i)
+        m_jobs.remove(done[i]);
+}
+
+int runServer(const QStringList &args)
+{
+    QTextStream out(stdout);
+    const quint16 port = quint16(argValue(args, "--port", "8470").toUInt());
+    int workers = argValue(args, "--workers", "0").toInt();
+    if (workers <= 0)
+        workers = QThread::idealThreadCount();
+
+    GAServer server(workers, argValue(args, "--output-root", "serve_out"));
+    QString err;
+    if (!server.listen(port, err)) {
+        out << "[serve] " << err << "\n";
+        return 1;
+    }
+    out << "[serve] listening on http://127.0.0.1:" << port << "/ | workers: " << workers
+        << " | output root: " << QDir(argValue(args, "--output-root", "serve_out")).absolutePath() << "\n";
+    out.flush();
+    return QCoreApplication::exec();
+}
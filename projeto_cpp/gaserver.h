@@ -0,0 +1,123 @@
+// gaserver.h
+#ifndef GASERVER_H
+#define GASERVER_H
+
+#include "gaengine.h"
+
+#include <QByteArray>
+#include <QHash>
+#include <QJsonObject>
+#include <QMap>
+#include <QObject>
+#include <QPointer>
+#include <QSharedPointer>
+#include <QStringList>
+#include <QThreadPool>
+#include <QVector>
+
+#include <atomic>
+
+class QTcpServer;
+class QTcpSocket;
+
+// Serviço residente:
+//   AeroportosGA --serve [--port 8470] [--workers N] [--output-root serve_out]
+// HTTP só em 127.0.0.1. Recusa requisições com Origin (vindas de páginas
+// no navegador) e POST sem Content-Type: application/json; o output_dir
+// dos jobs fica sempre dentro de --output-root. Mantém os cenários
+// carregados (entradas, genes, índices de slot, limite superior) em
+// memória, com o hash do conteúdo dos arquivos como chave. Cargas rodam
+// fora do laço de eventos, sem travar as outras requisições nem os
+// streams de progresso. Os jobs de GA entram numa fila com prioridade e
+// rodam num pool de workers compartilhado. Endpoints:
+//   POST   /scenarios          {"base_dir": ...} -> {"scenario": hash, "cached": ...}
+//                               (responde quando a carga termina)
+//   GET    /scenarios
+//   DELETE /scenarios/<hash>
+//   POST   /jobs               parâmetros do GA (ver gaserver.cpp) -> {"job": id}
+//                               (com base_dir: responde já, job em "loading")
+//   GET    /jobs               estado de todos
+//   GET    /jobs/<id>          estado, geração, melhor score, resumo
+//   GET    /jobs/<id>/events   progresso em Server-Sent Events até o fim
+//   GET    /jobs/<id>/result   flights_ga.json  (também /passengers, /stats)
+//   DELETE /jobs/<id>          cancela (na fila: sai; rodando: para na geração)
+int runServer(const QStringList &args);
+
+struct ServerJob {
+    int id = 0;
+    int priority = 0;
+    QString state;                  // loading, queued, running, done, cancelled, failed
+    QString scenarioKey;
+    ScenarioPtr scenario;
+    QJsonObject request;
+    QString outputDir;              // absoluto, dentro de --output-root
+    std::atomic<bool> stop{false};  // lido pelo worker
+
+    int generation = 0;
+    double bestScore = 0.0;
+    qint64 queuedMs = 0, startedMs = 0, finishedMs = 0;
+    QString error;
+    GAResult result;
+};
+
+class GAServer : public QObject
+{
+public:
+    GAServer(int workers, const QString &outputRoot, QObject *parent = nullptr);
+    ~GAServer() override;
+
+    bool listen(quint16 port, QString &error);
+
+private:
+    struct Request {
+        QByteArray method;
+        QByteArray path;
+        QByteArray body;
+        QByteArray host;
+        QByteArray contentType;
+        bool hasOrigin = false;
+    };
+
+    QTcpServer *m_server = nullptr;
+    QThreadPool m_pool;
+    QThreadPool m_loadPool;                          // cargas de cenário
+    int m_workers = 1;
+    QString m_outputRoot;
+    int m_running = 0;
+    int m_nextJobId = 1;
+
+    QHash<QString, ScenarioPtr> m_scenarios;         // hash do conteúdo -> cenário
+    QHash<QString, QString> m_scenarioDirs;
+    struct ScenarioLoad {                            // carga em andamento
+        QVector<QPointer<QTcpSocket>> waiters;       // POST /scenarios sem resposta
+        QVector<int> jobs;                           // jobs em "loading"
+    };
+    QHash<QString, ScenarioLoad> m_loads;            // base_dir absoluto -> carga
+    QMap<int, QSharedPointer<ServerJob>> m_jobs;     // ordem de criação
+    QVector<int> m_queue;
+    QHash<int, QVector<QTcpSocket *>> m_subscribers; // /events abertos por job
+    QHash<QTcpSocket *, QByteArray> m_buffers;
+
+    void onReadyRead(QTcpSocket *sock);
+    void handle(QTcpSocket *sock, const Request &req);
+    void reply(QTcpSocket *sock, const QByteArray &status, const QJsonObject &body);
+    void replyRaw(QTcpSocket *sock, const QByteArray &status, const QByteArray &type,
+                  const QByteArray &body);
+
+    bool startLoad(const QString &baseDir, QString &dirPath, QString &error);
+    void loadFinished(const QString &dirPath, const QString &key, ScenarioPtr data,
+                      bool cached, const QString &error, qint64 loadMs);
+    QJsonObject submitJob(const QJsonObject &req, QByteArray &status);
+    QJsonObject jobJson(const ServerJob &job) const;
+    void cancelJob(ServerJob &job);
+    void subscribe(QTcpSocket *sock, ServerJob &job);
+
+    void dispatch();
+    void runJob(const QSharedPointer<ServerJob> &job);
+    void jobProgress(int id, int gen, double best);
+    void jobFinished(int id);
+    void sendEvent(int id, const QByteArray &event, const QJsonObject &data, bool last);
+    void pruneFinished();
+};
+
+#endif // GASERVER_H
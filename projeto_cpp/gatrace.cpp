@@ -0,0 +1,188 @@
+// gatrace.cpp
+#include "gatrace.h"
+
+#include <QByteArray>
+#include <QFile>
+#include <QMutex>
+#include <QMutexLocker>
+
+#include <chrono>
+#include <memory>
+#include <vector>
+
+namespace GATrace {
+
+std::atomic<bool> g_enabled{false};
+
+namespace {
+
+struct Event {
+    const char *name;
+    const char *category;
+    qint64 startNs;
+    qint64 durNs;
+    int arg;
+};
+
+// Buffer de uma thread: blocos de tamanho fixo que nunca são realocados.
+// Só a thread dona escreve; o contador é publicado com release, então quem
+// lê com acquire vê eventos completos.
+constexpr int ChunkEvents = 4096;
+constexpr int MaxChunks   = 1024;   // até ~4M eventos por thread
+
+struct ThreadBuffer {
+    int tid = 0;
+    std::atomic<Event *> chunks[MaxChunks] = {};
+    std::atomic<qint64> count{0};
+    std::atomic<qint64> dropped{0};
+
+    ~ThreadBuffer()
+    {
+        for (auto &c : chunks)
+            delete[] c.load();
+    }
+
+    void push(const Event &e)
+    {
+        const qint64 n = count.load(std::memory_order_relaxed);
+        const int chunk = int(n / ChunkEvents);
+        if (chunk >= MaxChunks) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        Event *block = chunks[chunk].load(std::memory_order_relaxed);
+        if (!block) {
+            block = new Event[ChunkEvents];
+            chunks[chunk].store(block, std::memory_order_release);
+        }
+        block[n % ChunkEvents] = e;
+        count.store(n + 1, std::memory_order_release);
+    }
+};
+
+// registro global: só é tocado na primeira gravação de cada thread e no
+// dump; os buffers sobrevivem às threads (pool) até o fim do processo
+QMutex g_registryMutex;
+std::vector<std::unique_ptr<ThreadBuffer>> g_buffers;
+
+const auto g_origin = std::chrono::steady_clock::now();
+
+ThreadBuffer *threadBuffer()
+{
+    thread_local ThreadBuffer *buf = nullptr;
+    if (!buf) {
+        QMutexLocker lock(&g_registryMutex);
+        g_buffers.emplace_back(new ThreadBuffer);
+        buf = g_buffers.back().get();
+        buf->tid = int(g_buffers.size());
+    }
+    return buf;
+}
+
+void appendJsonString(QByteArray &out, const char *s)
+{
+    out += '"';
+    for (; *s; ++s) {
+        if (*s == '"' || *s == '\\') out += '\\';
+        out += *s;
+    }
+    out += '"';
+}
+
+} // namespace
+
+qint64 nowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now() - g_origin).count();
+}
+
+void record(const char *name, const char *category, qint64 startNs, qint64 durNs, int arg)
+{
+    threadBuffer()->push(Event{name, category, startNs, durNs, arg});
+}
+
+void start()
+{
+    {
+        QMutexLocker lock(&g_registryMutex);
+        for (auto &b : g_buffers) {
+            b->count.store(0, std::memory_order_relaxed);
+            b->dropped.store(0, std::memory_order_relaxed);
+        }
+    }
+    g_enabled.store(true);
+}
+
+void stop()
+{
+    g_enabled.store(false);
+}
+
+qint64 eventCount()
+{
+    QMutexLocker lock(&g_registryMutex);
+    qint64 n = 0;
+    for (auto &b : g_buffers)
+        n += b->count.load(std::memory_order_acquire);
+    return n;
+}
+
+qint64 droppedCount()
+{
+    QMutexLocker lock(&g_registryMutex);
+    qint64 n = 0;
+    for (auto &b : g_buffers)
+        n += b->dropped.load(std::memory_order_relaxed);
+    return n;
+}
+
+bool writeJson(const QString &path, QString &error)
+{
+    QFile f(path);
+    if (!f.open(QIODevice::WriteOnly)) {
+        error = QString("Cannot write %1").arg(path);
+        return false;
+    }
+
+    QMutexLocker lock(&g_registryMutex);
+    QByteArray out;
+    out.reserve(1 << 20);
+    out += "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    bool first = true;
+    for (auto &b : g_buffers) {
+        const qint64 n = b->count.load(std::memory_order_acquire);
+        if (n == 0) continue;
+
+        // nome da thread na timeline
+        if (!first) out += ",\n";
+        first = false;
+        out += "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":"
+               + QByteArray::number(b->tid) + ",\"args\":{\"name\":\""
+               + "thread " + QByteArray::number(b->tid) + "\"}}";
+
+        for (qint64 i = 0; i < n; ++i) {
+            const Event &e = b->chunks[i / ChunkEvents].load(std::memory_order_acquire)[i % ChunkEvents];
+            out += ",\n{\"ph\":\"X\",\"name\":";
+            appendJsonString(out, e.name);
+            out += ",\"cat\":";
+            appendJsonString(out, e.category);
+            out += ",\"pid\":1,\"tid\":" + QByteArray::number(b->tid);
+            out += ",\"ts\":" + QByteArray::number(e.startNs / 1000.0, 'f', 3);
+            out += ",\"dur\":" + QByteArray::number(e.durNs / 1000.0, 'f', 3);
+            if (e.arg >= 0)
+                out += ",\"args\":{\"n\":" + QByteArray::number(e.arg) + "}";
+            out += '}';
+
+            if (out.size() > (1 << 22)) {   // grava em blocos de ~4 MB
+                f.write(out);
+                out.clear();
+            }
+        }
+    }
+    out += "\n]}\n";
+    f.write(out);
+    return true;
+}
+
+} // namespace GATrace
@@ -0,0 +1,66 @@
+// gatrace.h
+#ifndef GATRACE_H
+#define GATRACE_H
+
+#include <QString>
+#include <QtGlobal>
+
+#include <atomic>
+
+// Gravador de timeline no formato Chrome Trace Event (abre no Perfetto ou
+// em chrome://tracing). Cada thread grava num buffer próprio, sem lock;
+// desligado, um escopo custa só a leitura de um atômico.
+//
+//   GATrace::start();
+//   { GA_TRACE_SCOPE("evaluateChromosome"); ... }
+//   GATrace::stop();
+//   GATrace::writeJson("ga_trace.json", err);
+namespace GATrace {
+
+extern std::atomic<bool> g_enabled;
+
+inline bool enabled() { return g_enabled.load(std::memory_order_relaxed); }
+
+// zera os buffers e começa a gravar (chamar com o GA parado)
+void start();
+void stop();
+// junta os buffers de todas as threads num JSON; chamar depois de stop()
+bool writeJson(const QString &path, QString &error);
+// eventos gravados / descartados por falta de espaço desde start()
+qint64 eventCount();
+qint64 droppedCount();
+
+qint64 nowNs();
+// name e category precisam ser literais (só o ponteiro é guardado)
+void record(const char *name, const char *category, qint64 startNs, qint64 durNs, int arg);
+
+class Scope
+{
+public:
+    explicit Scope(const char *name, const char *category = "ga", int arg = -1)
+        : m_name(name), m_category(category), m_arg(arg),
+          m_start(enabled() ? nowNs() : -1) {}
+    ~Scope()
+    {
+        if (m_start >= 0)
+            record(m_name, m_category, m_start, nowNs() - m_start, m_arg);
+    }
+    Scope(const Scope &) = delete;
+    Scope &operator=(const Scope &) = delete;
+
+private:
+    const char *m_name;
+    const char *m_category;
+    int m_arg;
+    qint64 m_start;
+};
+
+} // namespace GATrace
+
+#define GA_TRACE_CONCAT_(a, b) a##b
+#define GA_TRACE_CONCAT(a, b) GA_TRACE_CONCAT_(a, b)
+// escopo com nome literal e, opcionalmente, categoria e um inteiro (args.n)
+#define GA_TRACE_SCOPE(...) \
+    GATrace::Scope GA_TRACE_CONCAT(gaTraceScope_, __LINE__)(__VA_ARGS__)
+
+#endif // GATRACE_H
@@ -0,0 +1,314 @@
+// gatune.cpp
+#include "gatune.h"
+#include "gacli.h"
+#include "gaengine.h"
+#include "gametrics.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QRunnable>
+#include <QScopedPointer>
+#include <QTextStream>
+#include <QThread>
+#include <QThreadPool>
+
+#include <algorithm>
+#include <numeric>
+
+#ifdef Q_OS_WIN
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <ctime>
+#endif
+
+// Formato do sweep.json (caminhos relativos ao próprio arquivo):
+// {
+//   "base_dir": "airnet_inputs",
+//   "output_dir": "sweep_out",
+//   "mode": "grid",                  // ou "halving"
+//   "population": 60, "generations": 60,
+//   "seeds": [1, 2, 3],
+//   "p_cross": [0.6, 0.8, 0.95], "p_mut": [0.005, 0.01, 0.02],
+//   "elite_frac": [0.05, 0.1], "tournament": [2, 3, 4],
+//   "halving": { "min_generations": 10, "eta": 3 }
+// }
+// Listas ausentes usam o valor padrão de GAParams.
+//
+// Métrica: (melhor score final - melhor score da geração 0) / CPU-s,
+// somando todas as sementes. Com a mesma semente a população inicial é a
+// mesma em todas as configurações, então o ganho é comparável.
+
+namespace {
+
+// tempo de CPU da thread atual (cada execução do GA roda numa thread só)
+double threadCpuSeconds()
+{
+#ifdef Q_OS_WIN
+    FILETIME created, exited, kernel, user;
+    if (!GetThreadTimes(GetCurrentThread(), &created, &exited, &kernel, &user))
+        return 0.0;
+    ULARGE_INTEGER k, u;
+    k.LowPart  = kernel.dwLowDateTime;
+    k.HighPart = kernel.dwHighDateTime;
+    u.LowPart  = user.dwLowDateTime;
+    u.HighPart = user.dwHighDateTime;
+    return (k.QuadPart + u.QuadPart) / 1e7;
+#else
+    timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+#endif
+}
+
+QVector<double> doubleList(const QJsonObject &cfg, const QString &key, double def)
+{
+    QVector<double> out;
+    for (const QJsonValue &v : cfg.value(key).toArray())
+        out.append(v.toDouble(def));
+    if (out.isEmpty())
+        out.append(def);
+    return out;
+}
+
+struct SweepRun {
+    int config;
+    quint32 seed;
+    int generations;
+    double finalScore = 0.0;
+    double gain = 0.0;
+    double cpuSec = 0.0;
+};
+
+struct SweepRank {
+    int config;
+    double meanScore = 0.0;
+    double meanGain = 0.0;
+    double cpuSec = 0.0;
+    double rate = 0.0;   // ganho por CPU-s
+};
+
+} // namespace
+
+int runSweep(const QStringList &args)
+{
+    QTextStream out(stdout);
+
+    const QString sweepPath = argValue(args, "--sweep", QString());
+    QFile sf(sweepPath);
+    if (sweepPath.isEmpty() || !sf.open(QIODevice::ReadOnly)) {
+        out << "[sweep] cannot open sweep file: " << sweepPath << "\n";
+        return 1;
+    }
+    QJsonParseError pe;
+    QJsonDocument sweepDoc = QJsonDocument::fromJson(sf.readAll(), &pe);
+    sf.close();
+    if (pe.error != QJsonParseError::NoError) {
+        out << "[sweep] JSON parse error in " << sweepPath << ": " << pe.errorString() << "\n";
+        return 1;
+    }
+
+    const QJsonObject cfg = sweepDoc.object();
+    const QDir sweepDir = QFileInfo(sweepPath).absoluteDir();
+    const QDir baseDir(sweepDir.absoluteFilePath(cfg.value("base_dir").toString(".")));
+    const QDir outDir(sweepDir.absoluteFilePath(cfg.value("output_dir").toString("sweep_out")));
+    const int population  = cfg.value("population").toInt(60);
+    const int generations = qMax(1, cfg.value("generations").toInt(60));
+    const bool halving    = (cfg.value("mode").toString("grid") == "halving");
+    int threads = argValue(args, "--threads",
+                           QString::number(cfg.value("threads").toInt(0))).toInt();
+    if (threads <= 0)
+        threads = QThread::idealThreadCount();
+
+    QVector<quint32> seeds;
+    for (const QJsonValue &v : cfg.value("seeds").toArray())
+        seeds.append((quint32)v.toInt());
+    if (seeds.isEmpty())
+        seeds.append(1);
+
+    // grade completa de configurações
+    const GAParams def;
+    QVector<GAParams> configs;
+    for (double pc : doubleList(cfg, "p_cross", def.pCross))
+        for (double pm : doubleList(cfg, "p_mut", def.pMut))
+            for (double ef : doubleList(cfg, "elite_frac", def.eliteFrac))
+                for (double ts : doubleList(cfg, "tournament", def.tournamentSize)) {
+                    GAParams p;
+                    p.pCross         = pc;
+                    p.pMut           = pm;
+                    p.eliteFrac      = ef;
+                    p.tournamentSize = (int)ts;
+                    configs.append(p);
+                }
+
+    QString err;
+    ScenarioPtr base = GAEngine::loadScenario(baseDir.filePath("airports.json"),
+                                              baseDir.filePath("routes.json"),
+                                              baseDir.filePath("passengers.json"),
+                                              baseDir.filePath("fleet.json"),
+                                              baseDir.filePath("forbidden_routes.json"),
+                                              err);
+    if (!base) {
+        out << "[sweep] " << err << "\n";
+        return 1;
+    }
+    if (!QDir().mkpath(outDir.absolutePath())) {
+        out << "[sweep] cannot create output dir " << outDir.absolutePath() << "\n";
+        return 1;
+    }
+
+    const QJsonObject halvingCfg = cfg.value("halving").toObject();
+    const int eta = qMax(2, halvingCfg.value("eta").toInt(3));
+    int roundGens = halving
+        ? qBound(1, halvingCfg.value("min_generations").toInt(generations / 9), generations)
+        : generations;
+
+    out << "[sweep] scenario: " << baseDir.absolutePath()
+        << " | configs: " << configs.size()
+        << " | seeds: " << seeds.size()
+        << " | mode: " << (halving ? "halving" : "grid")
+        << " | threads: " << threads << "\n";
+    out.flush();
+
+    const QString csvPath = outDir.filePath("sweep_results.csv");
+    QFile csv(csvPath);
+    if (!csv.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        out << "[sweep] cannot write " << csvPath << "\n";
+        return 1;
+    }
+    QTextStream cs(&csv);
+    cs << "round,generations,p_cross,p_mut,elite_frac,tournament,seeds,"
+          "mean_score,mean_gain,cpu_s,gain_per_cpu_s\n";
+
+    // endpoint de métricas opcional (--metrics-port N)
+    const int metricsPort = argValue(args, "--metrics-port", "0").toInt();
+    QScopedPointer<MetricsServer> metricsServer;
+    if (metricsPort > 0) {
+        metricsServer.reset(new MetricsServer((quint16)metricsPort));
+        if (!metricsServer->startServer(err)) {
+            out << "[sweep] " << err << "\n";
+            return 1;
+        }
+        out << "[sweep] metrics: http://127.0.0.1:" << metricsPort << "/metrics\n";
+        out.flush();
+    }
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(threads);
+    QMutex outMutex;
+
+    QVector<int> alive(configs.size());
+    std::iota(alive.begin(), alive.end(), 0);
+    QVector<SweepRank> ranking;
+
+    for (int round = 0; ; ++round) {
+        QVector<SweepRun> runs;
+        for (int c : alive)
+            for (quint32 seed : seeds)
+                runs.append({c, seed, roundGens});
+
+        // cada tarefa escreve só no seu elemento (sem detach concorrente)
+        SweepRun *runData = runs.data();
+        for (int i = 0; i < runs.size(); ++i) {
+            pool.start(QRunnable::create([&, runData, i]() {
+                SweepRun &run = runData[i];
+                GAEngine engine;
+                engine.setScenario(base);
+                engine.setGAParams(configs.at(run.config));
+                engine.setSeed(run.seed);
+                if (metricsServer) {
+                    QSharedPointer<GAMetrics> metrics = QSharedPointer<GAMetrics>::create();
+                    metricsServer->addRun(QString("r%1_c%2_s%3").arg(round).arg(run.config).arg(run.seed), metrics);
+                    engine.setMetrics(metrics);
+                }
+
+                const double cpu0 = threadCpuSeconds();
+                GAResult res = engine.runGA(population, run.generations);
+                run.cpuSec = threadCpuSeconds() - cpu0;
+
+                const QJsonArray evo = res.evolutionJson.object().value("evolution").toArray();
+                const double initial = evo.isEmpty()
+                    ? res.bestScore : evo.first().toObject().value("best_score").toDouble();
+                run.finalScore = res.bestScore;
+                run.gain       = res.bestScore - initial;
+
+                QMutexLocker lock(&outMutex);
+                out << QString("[sweep] round %1 | config %2 seed %3 | score %4 | %5 CPU-s\n")
+                           .arg(round).arg(run.config).arg(run.seed)
+                           .arg(run.finalScore, 0, 'f', 0)
+                           .arg(run.cpuSec, 0, 'f', 2);
+                out.flush();
+            }));
+        }
+        pool.waitForDone();
+
+        ranking.clear();
+        for (int c : alive) {
+            SweepRank r;
+            r.config = c;
+            double gainSum = 0.0, scoreSum = 0.0;
+            int n = 0;
+            for (const SweepRun &run : runs) {
+                if (run.config != c) continue;
+                gainSum  += run.gain;
+                scoreSum += run.finalScore;
+                r.cpuSec += run.cpuSec;
+                ++n;
+            }
+            r.meanScore = scoreSum / qMax(1, n);
+            r.meanGain  = gainSum / qMax(1, n);
+            r.rate      = r.cpuSec > 0.0 ? gainSum / r.cpuSec : 0.0;
+            ranking.append(r);
+        }
+        std::sort(ranking.begin(), ranking.end(), [](const SweepRank &a, const SweepRank &b) {
+            if (a.rate != b.rate) return a.rate > b.rate;
+            return a.meanScore > b.meanScore;
+        });
+
+        for (const SweepRank &r : ranking) {
+            const GAParams &p = configs[r.config];
+            cs << round << ',' << roundGens << ','
+               << p.pCross << ',' << p.pMut << ',' << p.eliteFrac << ','
+               << p.tournamentSize << ',' << seeds.size() << ','
+               << QString::number(r.meanScore, 'f', 2) << ','
+               << QString::number(r.meanGain, 'f', 2) << ','
+               << QString::number(r.cpuSec, 'f', 3) << ','
+               << QString::number(r.rate, 'f', 2) << '\n';
+        }
+
+        if (!halving || ranking.size() <= 1 || roundGens >= generations)
+            break;
+
+        // successive halving: fica 1/eta das configurações, com eta x gerações
+        const int keep = qMax(1, ranking.size() / eta);
+        alive.clear();
+        for (int i = 0; i < keep; ++i)
+            alive.append(ranking[i].config);
+        roundGens = qMin(generations, roundGens * eta);
+    }
+
+    out << QString("\n%1 %2 %3 %4 %5 %6 %7\n")
+               .arg("p_cross", 8).arg("p_mut", 8).arg("elite", 6).arg("tour", 5)
+               .arg("mean_score", 14).arg("cpu_s", 9).arg("gain/cpu_s", 14);
+    for (int i = 0; i < qMin(10, ranking.size()); ++i) {
+        const SweepRank &r = ranking[i];
+        const GAParams &p = configs[r.config];
+        out << QString("%1 %2 %3 %4 %5 %6 %7\n")
+                   .arg(p.pCross, 8, 'f', 3)
+                   .arg(p.pMut, 8, 'f', 4)
+                   .arg(p.eliteFrac, 6, 'f', 2)
+                   .arg(p.tournamentSize, 5)
+                   .arg(r.meanScore, 14, 'f', 0)
+                   .arg(r.cpuSec, 9, 'f', 2)
+                   .arg(r.rate, 14, 'f', 1);
+    }
+    out << "\n[sweep] results: " << csvPath << "\n";
+    return 0;
+}
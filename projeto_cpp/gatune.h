@@ -0,0 +1,14 @@
+// gatune.h
+#ifndef GATUNE_H
+#define GATUNE_H
+
+#include <QStringList>
+
+// Modo headless de varredura de hiperparâmetros:
+//   AeroportosGA --sweep <sweep.json> [--threads N] [--metrics-port P]
+// Roda combinações de pCross / pMut / eliteFrac / torneio com sementes
+// fixas, em paralelo, em grade ou por successive halving, e ordena pelo
+// ganho de score por segundo de CPU (sweep_results.csv).
+int runSweep(const QStringList &args);
+
+#endif // GATUNE_H
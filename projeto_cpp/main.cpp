@@ -1,9 +1,49 @@
 // main.cpp
 #include <QApplication>
+#include <QCoreApplication>
+#include <QString>
 #include "mainwindow.h"
+#include "gabench.h"
+#include "gabatch.h"
+#include "garecovery.h"
+#include "garobust.h"
+#include "gaserver.h"
+#include "gatune.h"
 
 int main(int argc, char *argv[])
 {
+    // modo headless (sem janela)
+    for (int i = 1; i < argc; ++i) {
+        if (QString(argv[i]) == "--bench") {
+            QCoreApplication app(argc, argv);
+            return runBenchmark(app.arguments());
+        }
+        if (QString(argv[i]) == "--perf-check") {
+            QCoreApplication app(argc, argv);
+            return runPerfCheck(app.arguments());
+        }
+        if (QString(argv[i]) == "--batch") {
+            QCoreApplication app(argc, argv);
+            return runBatch(app.arguments());
+        }
+        if (QString(argv[i]) == "--sweep") {
+            QCoreApplication app(argc, argv);
+            return runSweep(app.arguments());
+        }
+        if (QString(argv[i]) == "--robust") {
+            QCoreApplication app(argc, argv);
+            return runRobustness(app.arguments());
+        }
+        if (QString(argv[i]) == "--recover") {
+            QCoreApplication app(argc, argv);
+            return runRecovery(app.arguments());
+        }
+        if (QString(argv[i]) == "--serve") {
+            QCoreApplication app(argc, argv);
+            return runServer(app.arguments());
+        }
+    }
+
     QApplication a(argc, argv);
     MainWindow w;
     w.resize(1000, 700);
@@ -1,5 +1,9 @@
 // mainwindow.cpp
 #include "mainwindow.h"
+#include "gacolumns.h"
+#include "gamarginal.h"
+#include "gametrics.h"
+#include "gatrace.h"
 
 #include <QFileDialog>
 #include <QHBoxLayout>
@@ -8,11 +12,16 @@
 #include <QLabel>
 #include <QLineEdit>
 #include <QSpinBox>
+#include <QCheckBox>
+#include <QComboBox>
 #include <QPushButton>
 #include <QTextEdit>
 #include <QProgressBar>
 #include <QFileInfo>
 #include <QDateTime>
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QJsonObject>
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent),
@@ -74,6 +83,16 @@ MainWindow::MainWindow(QWidget *parent)
     rowForbidden->addWidget(btnForbidden);
     mainLayout->addLayout(rowForbidden);
 
+    // Linha Warm start (opcional): flights_ga.json de uma execução anterior
+    auto *rowWarm = new QHBoxLayout;
+    rowWarm->addWidget(new QLabel("Warm start flights JSON (optional):", this));
+    m_warmStartEdit = new QLineEdit(this);
+    rowWarm->addWidget(m_warmStartEdit);
+    auto *btnWarm = new QPushButton("...", this);
+    connect(btnWarm, &QPushButton::clicked, this, &MainWindow::browseWarmStart);
+    rowWarm->addWidget(btnWarm);
+    mainLayout->addLayout(rowWarm);
+
     // Linha pop / gen + botão
     auto *rowTop = new QHBoxLayout;
     rowTop->addWidget(new QLabel("Population:", this));
@@ -94,6 +113,129 @@ MainWindow::MainWindow(QWidget *parent)
 
     mainLayout->addLayout(rowTop);
 
+    // Linha operadores do GA
+    const GAParams gaDefaults;
+    auto *rowOps = new QHBoxLayout;
+    rowOps->addWidget(new QLabel("Crossover p:", this));
+    m_pCrossSpin = new QDoubleSpinBox(this);
+    m_pCrossSpin->setRange(0.0, 1.0);
+    m_pCrossSpin->setSingleStep(0.05);
+    m_pCrossSpin->setValue(gaDefaults.pCross);
+    rowOps->addWidget(m_pCrossSpin);
+
+    rowOps->addWidget(new QLabel("Mutation p:", this));
+    m_pMutSpin = new QDoubleSpinBox(this);
+    m_pMutSpin->setDecimals(4);
+    m_pMutSpin->setRange(0.0, 1.0);
+    m_pMutSpin->setSingleStep(0.001);
+    m_pMutSpin->setValue(gaDefaults.pMut);
+    rowOps->addWidget(m_pMutSpin);
+
+    rowOps->addWidget(new QLabel("Elite fraction:", this));
+    m_eliteSpin = new QDoubleSpinBox(this);
+    m_eliteSpin->setRange(0.0, 1.0);
+    m_eliteSpin->setSingleStep(0.05);
+    m_eliteSpin->setValue(gaDefaults.eliteFrac);
+    rowOps->addWidget(m_eliteSpin);
+
+    rowOps->addWidget(new QLabel("Tournament:", this));
+    m_tourSpin = new QSpinBox(this);
+    m_tourSpin->setRange(1, 16);
+    m_tourSpin->setValue(gaDefaults.tournamentSize);
+    rowOps->addWidget(m_tourSpin);
+
+    rowOps->addWidget(new QLabel("Metrics port:", this));
+    m_metricsPortSpin = new QSpinBox(this);
+    m_metricsPortSpin->setRange(0, 65535);
+    m_metricsPortSpin->setValue(0);
+    m_metricsPortSpin->setSpecialValueText("off");
+    m_metricsPortSpin->setToolTip("Serve live Prometheus metrics on http://127.0.0.1:<port>/metrics");
+    rowOps->addWidget(m_metricsPortSpin);
+    rowOps->addStretch();
+
+    mainLayout->addLayout(rowOps);
+
+    // Linha opções do GA
+    auto *rowOpts = new QHBoxLayout;
+    m_repairCheck = new QCheckBox("Repair infeasible genes", this);
+    m_repairCheck->setToolTip("Clear genes the evaluator could not assign or pruned");
+    rowOpts->addWidget(m_repairCheck);
+
+    m_adaptiveCheck = new QCheckBox("Adaptive mutation", this);
+    m_adaptiveCheck->setToolTip("Raise mutation when population diversity collapses and inject random immigrants after a long stall");
+    rowOpts->addWidget(m_adaptiveCheck);
+
+    rowOpts->addWidget(new QLabel("Chromosome:", this));
+    m_chromCombo = new QComboBox(this);
+    m_chromCombo->addItem("Auto", (int)GAEngine::ChromosomeMode::Auto);
+    m_chromCombo->addItem("Dense", (int)GAEngine::ChromosomeMode::Dense);
+    m_chromCombo->addItem("Sparse", (int)GAEngine::ChromosomeMode::Sparse);
+    m_chromCombo->setToolTip("Sparse keeps only active gene ids (large slot universes)");
+    rowOpts->addWidget(m_chromCombo);
+
+    rowOpts->addWidget(new QLabel("Gene order:", this));
+    m_layoutCombo = new QComboBox(this);
+    m_layoutCombo->addItem("Scenario", -1);
+    m_layoutCombo->addItem("Route", (int)GeneLayout::Route);
+    m_layoutCombo->addItem("Airport / time", (int)GeneLayout::AirportTime);
+    m_layoutCombo->setToolTip("Number genes route by route, or grouped by origin airport and departure time (Scenario = meta.json gene_layout)");
+    rowOpts->addWidget(m_layoutCombo);
+
+    rowOpts->addWidget(new QLabel("Crossover:", this));
+    m_crossoverCombo = new QComboBox(this);
+    m_crossoverCombo->addItem("One-point", (int)GAEngine::CrossoverMode::OnePoint);
+    m_crossoverCombo->addItem("Airport blocks", (int)GAEngine::CrossoverMode::AirportBlocks);
+    m_crossoverCombo->addItem("Time blocks", (int)GAEngine::CrossoverMode::TimeBlocks);
+    m_crossoverCombo->setToolTip("Swap whole gene blocks (origin airport or route; or departure window) between parents");
+    rowOpts->addWidget(m_crossoverCombo);
+
+    rowOpts->addWidget(new QLabel("Routing:", this));
+    m_routingCombo = new QComboBox(this);
+    m_routingCombo->addItem("Time-expanded", (int)GAEngine::RoutingMode::TimeExpanded);
+    m_routingCombo->addItem("Greedy (fast)", (int)GAEngine::RoutingMode::Greedy);
+    rowOpts->addWidget(m_routingCombo);
+
+    rowOpts->addWidget(new QLabel("Max legs:", this));
+    m_maxLegsSpin = new QSpinBox(this);
+    m_maxLegsSpin->setRange(1, 6);
+    m_maxLegsSpin->setValue(GAConst::MaxLegs);
+    rowOpts->addWidget(m_maxLegsSpin);
+
+    rowOpts->addWidget(new QLabel("Pre-screen:", this));
+    m_screenCombo = new QComboBox(this);
+    m_screenCombo->addItem("Off", (int)GAEngine::ScreeningMode::Off);
+    m_screenCombo->addItem("Seat bound", (int)GAEngine::ScreeningMode::Bound);
+    m_screenCombo->addItem("Surrogate", (int)GAEngine::ScreeningMode::Surrogate);
+    m_screenCombo->setToolTip("Skip full evaluation of children that cannot reach the parents' median");
+    rowOpts->addWidget(m_screenCombo);
+
+    rowOpts->addWidget(new QLabel("Stop at gap %:", this));
+    m_gapSpin = new QDoubleSpinBox(this);
+    m_gapSpin->setRange(0.0, 100.0);
+    m_gapSpin->setDecimals(2);
+    m_gapSpin->setValue(0.0);
+    m_gapSpin->setToolTip("Stop when (upper bound - best) / |upper bound| falls below this; 0 = never");
+    rowOpts->addWidget(m_gapSpin);
+
+    m_paretoCheck = new QCheckBox("Multi-objective (NSGA-II)", this);
+    m_paretoCheck->setToolTip("Evolve the Pareto front of served passengers, travel time and aircraft used; writes pareto_front.json");
+    rowOpts->addWidget(m_paretoCheck);
+
+    m_columnarCheck = new QCheckBox("Columnar output", this);
+    m_columnarCheck->setToolTip("Also write flights, assignments, legs and GA history as columns in ga_results.gacol (memory-mappable from Python)");
+    rowOpts->addWidget(m_columnarCheck);
+
+    m_marginalCheck = new QCheckBox("Marginal value", this);
+    m_marginalCheck->setToolTip("Score / passengers lost by cancelling each flight and best inactive flights to add; writes marginal_value.json");
+    rowOpts->addWidget(m_marginalCheck);
+
+    m_traceCheck = new QCheckBox("Trace", this);
+    m_traceCheck->setToolTip("Record a timeline of loading, generations, evaluations and output writing; writes ga_trace.json (open in Perfetto)");
+    rowOpts->addWidget(m_traceCheck);
+    rowOpts->addStretch();
+
+    mainLayout->addLayout(rowOpts);
+
     // Barra de progresso + status
     auto *rowStatus = new QHBoxLayout;
     m_statusLabel = new QLabel("Ready.", this);
@@ -155,6 +297,14 @@ void MainWindow::browseForbidden()
         m_forbiddenEdit->setText(fn);
 }
 
+void MainWindow::browseWarmStart()
+{
+    QString fn = QFileDialog::getOpenFileName(
+        this, "Select previous flights_ga.json", QString(), "JSON Files (*.json)");
+    if (!fn.isEmpty())
+        m_warmStartEdit->setText(fn);
+}
+
 QString MainWindow::buildProgressLine(int gen, int maxGen, double bestScore) const
 {
     return QString("[GA] Gen %1/%2 | best score = %3")
@@ -183,17 +333,82 @@ void MainWindow::runGA()
     m_statusLabel->setText("Loading data...");
     m_progressBar->setValue(0);
 
+    const bool trace = m_traceCheck->isChecked();
+    if (trace)
+        GATrace::start();
+
     QString err;
     if (!m_engine.loadData(airportsPath, routesPath, passengersPath, fleetPath, forbiddenPath, err)) {
+        GATrace::stop();
         m_statusLabel->setText("Error loading data.");
         m_outputEdit->setPlainText(err);
         m_runButton->setEnabled(true);
         return;
     }
 
+    // ordem dos genes: antes do warm start, que é casado pelos ids novos
+    // ("Scenario" = a do meta.json)
+    const int layout = m_layoutCombo->currentData().toInt();
+    if (layout >= 0 && (GeneLayout)layout != m_engine.scenario()->params.geneLayout)
+        m_engine.setScenario(GAEngine::withGeneLayout(m_engine.scenario(), (GeneLayout)layout));
+
+    QString warmStartPath = m_warmStartEdit->text().trimmed();
+    if (!warmStartPath.isEmpty()
+        && !m_engine.loadWarmStart(warmStartPath, err)) {
+        GATrace::stop();
+        m_statusLabel->setText("Error loading warm start.");
+        m_outputEdit->setPlainText(err);
+        m_runButton->setEnabled(true);
+        return;
+    }
+
     const int pop = m_popSpin->value();
     const int gens = m_genSpin->value();
 
+    GAParams gaParams;
+    gaParams.pCross         = m_pCrossSpin->value();
+    gaParams.pMut           = m_pMutSpin->value();
+    gaParams.eliteFrac      = m_eliteSpin->value();
+    gaParams.tournamentSize = m_tourSpin->value();
+    m_engine.setGAParams(gaParams);
+    m_engine.setRepairEnabled(m_repairCheck->isChecked());
+    m_engine.setAdaptiveMutation(m_adaptiveCheck->isChecked());
+    m_engine.setRoutingMode(
+        (GAEngine::RoutingMode)m_routingCombo->currentData().toInt());
+    m_engine.setMaxLegs(m_maxLegsSpin->value());
+    m_engine.setGapStopThreshold(m_gapSpin->value() / 100.0);
+    m_engine.setMultiObjective(m_paretoCheck->isChecked());
+
+    // endpoint de métricas: recriado se a porta mudou
+    const int metricsPort = m_metricsPortSpin->value();
+    QString metricsInfo;
+    if (m_metricsServer && (metricsPort == 0 || m_metricsServer->port() != metricsPort)) {
+        delete m_metricsServer;
+        m_metricsServer = nullptr;
+    }
+    if (metricsPort > 0 && !m_metricsServer) {
+        m_metricsServer = new MetricsServer((quint16)metricsPort, this);
+        if (!m_metricsServer->startServer(err)) {
+            delete m_metricsServer;
+            m_metricsServer = nullptr;
+            metricsInfo = "[ERROR] " + err + "\n";
+        }
+    }
+    if (m_metricsServer) {
+        m_metrics = QSharedPointer<GAMetrics>::create();
+        m_metricsServer->addRun("gui", m_metrics);
+        metricsInfo = QString("Metrics: http://127.0.0.1:%1/metrics\n").arg(metricsPort);
+    } else {
+        m_metrics.reset();
+    }
+    m_engine.setMetrics(m_metrics);
+    m_engine.setScreeningMode(
+        (GAEngine::ScreeningMode)m_screenCombo->currentData().toInt());
+    m_engine.setChromosomeMode(
+        (GAEngine::ChromosomeMode)m_chromCombo->currentData().toInt());
+    m_engine.setCrossoverMode(
+        (GAEngine::CrossoverMode)m_crossoverCombo->currentData().toInt());
+
     m_statusLabel->setText(QString("Running GA (%1 individuals, %2 generations)...")
                                .arg(pop).arg(gens));
     qApp->processEvents();
@@ -217,40 +432,101 @@ void MainWindow::runGA()
     txt += QString("Best score: %1\n").arg(res.bestScore, 0, 'f', 2);
     txt += "\n";
     txt += res.summaryText;
+    txt += metricsInfo;
+    txt += "\nInputs (parsed in parallel):\n";
+    for (const InputFileStats &st : m_engine.scenario()->inputStats)
+        txt += QString("  %1 %2 KB in %3 ms\n")
+                   .arg(st.file)
+                   .arg(st.bytes / 1024.0, 0, 'f', 1)
+                   .arg(st.parseMs, 0, 'f', 1);
 
     // salva JSONs ao lado do arquivo de passageiros, por convenção
     QFileInfo paxInfo(m_passengersEdit->text().trimmed());
     QString baseDir = paxInfo.absolutePath();
 
-    QString flightsPath = baseDir + "/flights_ga.json";
-    QString paxFlightsPath = baseDir + "/passengers_flights.json";
-    QString statsPath = baseDir + "/ga_stats.json";
-
-    QFile f1(flightsPath);
-    if (f1.open(QIODevice::WriteOnly)) {
-        f1.write(res.fullJson.toJson(QJsonDocument::Indented));
-        f1.close();
-        txt += "\nSaved flights JSON: " + flightsPath + "\n";
-    } else {
-        txt += "\n[ERROR] Could not save flights_ga.json\n";
-    }
-
-    QFile f2(paxFlightsPath);
-    if (f2.open(QIODevice::WriteOnly)) {
-        f2.write(res.passengersJson.toJson(QJsonDocument::Indented));
-        f2.close();
-        txt += "Saved passengers_flights JSON: " + paxFlightsPath + "\n";
-    } else {
-        txt += "\n[ERROR] Could not save passengers_flights.json\n";
+    {
+        GA_TRACE_SCOPE("writeOutputs", "output");
+        QString flightsPath = baseDir + "/flights_ga.json";
+        QString paxFlightsPath = baseDir + "/passengers_flights.json";
+        QString statsPath = baseDir + "/ga_stats.json";
+
+        QFile f1(flightsPath);
+        if (f1.open(QIODevice::WriteOnly)) {
+            f1.write(res.fullJson.toJson(QJsonDocument::Indented));
+            f1.close();
+            txt += "\nSaved flights JSON: " + flightsPath + "\n";
+        } else {
+            txt += "\n[ERROR] Could not save flights_ga.json\n";
+        }
+
+        QFile f2(paxFlightsPath);
+        if (f2.open(QIODevice::WriteOnly)) {
+            f2.write(res.passengersJson.toJson(QJsonDocument::Indented));
+            f2.close();
+            txt += "Saved passengers_flights JSON: " + paxFlightsPath + "\n";
+        } else {
+            txt += "\n[ERROR] Could not save passengers_flights.json\n";
+        }
+
+        QFile f3(statsPath);
+        if (f3.open(QIODevice::WriteOnly)) {
+            f3.write(res.evolutionJson.toJson(QJsonDocument::Indented));
+            f3.close();
+            txt += "Saved GA stats JSON: " + statsPath + "\n";
+        } else {
+            txt += "\n[ERROR] Could not save ga_stats.json\n";
+        }
+
+        if (!res.paretoJson.isNull()) {
+            QString paretoPath = baseDir + "/pareto_front.json";
+            QFile f4(paretoPath);
+            if (f4.open(QIODevice::WriteOnly)) {
+                f4.write(res.paretoJson.toJson(QJsonDocument::Indented));
+                f4.close();
+                txt += "Saved Pareto front JSON: " + paretoPath + "\n";
+            } else {
+                txt += "\n[ERROR] Could not save pareto_front.json\n";
+            }
+        }
+
+        if (m_columnarCheck->isChecked()) {
+            const QString colPath = baseDir + "/ga_results.gacol";
+            if (writeColumnar(colPath, resultColumns(res), err))
+                txt += "Saved columnar results: " + colPath + "\n";
+            else
+                txt += "\n[ERROR] " + err + "\n";
+        }
+
+        if (m_marginalCheck->isChecked()) {
+            QElapsedTimer mt;
+            mt.start();
+            const QJsonObject marginal = marginalValueReport(m_engine, res);
+            const QString margPath = baseDir + "/marginal_value.json";
+            QFile f5(margPath);
+            if (f5.open(QIODevice::WriteOnly)) {
+                f5.write(QJsonDocument(marginal).toJson(QJsonDocument::Indented));
+                f5.close();
+                txt += QString("Saved marginal values (%1 flights, %2 candidates, %3 s): %4\n")
+                           .arg(marginal.value("removal").toArray().size())
+                           .arg(marginal.value("candidates_evaluated").toInt())
+                           .arg(mt.elapsed() / 1000.0, 0, 'f', 1)
+                           .arg(margPath);
+            } else {
+                txt += "\n[ERROR] Could not save marginal_value.json\n";
+            }
+        }
     }
 
-    QFile f3(statsPath);
-    if (f3.open(QIODevice::WriteOnly)) {
-        f3.write(res.evolutionJson.toJson(QJsonDocument::Indented));
-        f3.close();
-        txt += "Saved GA stats JSON: " + statsPath + "\n";
-    } else {
-        txt += "\n[ERROR] Could not save ga_stats.json\n";
+    if (trace) {
+        GATrace::stop();
+        const QString tracePath = baseDir + "/ga_trace.json";
+        if (GATrace::writeJson(tracePath, err)) {
+            txt += QString("Saved trace (%1 events): %2\n").arg(GATrace::eventCount()).arg(tracePath);
+            if (GATrace::droppedCount() > 0)
+                txt += QString("[WARN] trace buffer full, %1 events dropped\n").arg(GATrace::droppedCount());
+        } else {
+            txt += "\n[ERROR] " + err + "\n";
+        }
     }
 
     m_outputEdit->setPlainText(txt);
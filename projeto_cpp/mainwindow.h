@@ -8,9 +8,14 @@
 class QLineEdit;
 class QPushButton;
 class QSpinBox;
+class QDoubleSpinBox;
 class QTextEdit;
 class QLabel;
 class QProgressBar;
+class QCheckBox;
+class QComboBox;
+class MetricsServer;
+class GAMetrics;
 
 #include "gaengine.h"
 
@@ -26,6 +31,7 @@ private slots:
     void browsePassengers();
     void browseFleet();
     void browseForbidden();
+    void browseWarmStart();
     void runGA();
 
 private:
@@ -34,14 +40,35 @@ private:
     QLineEdit   *m_passengersEdit;
     QLineEdit   *m_fleetEdit;
     QLineEdit   *m_forbiddenEdit;
+    QLineEdit   *m_warmStartEdit;
     QSpinBox    *m_popSpin;
     QSpinBox    *m_genSpin;
+    QDoubleSpinBox *m_pCrossSpin;
+    QDoubleSpinBox *m_pMutSpin;
+    QDoubleSpinBox *m_eliteSpin;
+    QSpinBox    *m_tourSpin;
+    QCheckBox   *m_repairCheck;
+    QCheckBox   *m_adaptiveCheck;
+    QCheckBox   *m_paretoCheck;
+    QCheckBox   *m_columnarCheck;
+    QCheckBox   *m_marginalCheck;
+    QCheckBox   *m_traceCheck;
+    QComboBox   *m_chromCombo;
+    QComboBox   *m_layoutCombo;
+    QComboBox   *m_crossoverCombo;
+    QComboBox   *m_routingCombo;
+    QSpinBox    *m_maxLegsSpin;
+    QComboBox   *m_screenCombo;
+    QDoubleSpinBox *m_gapSpin;
+    QSpinBox    *m_metricsPortSpin;
     QTextEdit   *m_outputEdit;
     QLabel      *m_statusLabel;
     QProgressBar *m_progressBar;
     QPushButton *m_runButton;
 
     GAEngine     m_engine;
+    MetricsServer *m_metricsServer = nullptr;
+    QSharedPointer<GAMetrics> m_metrics;
 
     QString buildProgressLine(int gen, int maxGen, double bestScore) const;
 };
@@ -0,0 +1,119 @@
+// paxrouter.cpp
+#include "paxrouter.h"
+
+#include <algorithm>
+#include <climits>
+#include <numeric>
+
+namespace {
+constexpr int NoLabel = INT_MIN;
+}
+
+TimeExpandedRouter::TimeExpandedRouter(const QVector<FlightInstance> &flights,
+                                       int numAirports, int minConnMin, int maxLegs)
+    : m_flights(flights),
+    m_minConn(minConnMin),
+    m_maxLegs(qMax(1, maxLegs))
+{
+    const int F = flights.size();
+    m_byArrival.resize(F);
+    std::iota(m_byArrival.begin(), m_byArrival.end(), 0);
+    std::sort(m_byArrival.begin(), m_byArrival.end(), [&](int a, int b) {
+        return flights[a].arrMin < flights[b].arrMin;
+    });
+
+    m_label.resize((m_maxLegs + 1) * F);
+    m_prev.resize((m_maxLegs + 1) * F);
+    m_best.resize(numAirports);
+    m_bestFrom.resize(numAirports);
+}
+
+bool TimeExpandedRouter::findPath(int orig, int dest, QVector<int> &path)
+{
+    path.clear();
+    const int F = m_flights.size();
+    if (F == 0 || orig == dest)
+        return false;
+
+    // nível 1: voos diretos saindo da origem
+    bool any = false;
+    int *lab1 = label(1);
+    int *prev1 = prev(1);
+    for (int f = 0; f < F; ++f) {
+        prev1[f] = -1;
+        if (m_flights[f].orig == orig && hasSeat(f)) {
+            lab1[f] = m_flights[f].depMin;
+            any = true;
+        } else {
+            lab1[f] = NoLabel;
+        }
+    }
+    if (!any)
+        return false;
+
+    // nível k: varre partidas em ordem de horário; as chegadas que já
+    // cumprem a conexão mínima atualizam o melhor rótulo do aeroporto
+    int levels = 1;
+    for (int k = 2; k <= m_maxLegs; ++k) {
+        const int *labPrev  = label(k - 1);
+        const int *prevPrev = prev(k - 1);
+        int *lab = label(k);
+        int *prv = prev(k);
+        std::fill(m_best.begin(), m_best.end(), NoLabel);
+
+        bool improved = false;
+        int r = 0;
+        for (int f = 0; f < F; ++f) {
+            const FlightInstance &fl = m_flights[f];
+            while (r < F && m_flights[m_byArrival[r]].arrMin + m_minConn <= fl.depMin) {
+                const int g = m_byArrival[r++];
+                const int a = m_flights[g].dest;
+                if (labPrev[g] > m_best[a]) {
+                    m_best[a]     = labPrev[g];
+                    m_bestFrom[a] = g;
+                }
+            }
+
+            lab[f] = labPrev[f];
+            prv[f] = prevPrev[f];
+            if (!hasSeat(f))
+                continue;
+            if (m_best[fl.orig] > lab[f]) {
+                lab[f] = m_best[fl.orig];
+                prv[f] = m_bestFrom[fl.orig];
+                improved = true;
+            }
+        }
+        levels = k;
+        if (!improved)
+            break;
+    }
+
+    // melhor chegada no destino (menor tempo de viagem)
+    const int *labLast = label(levels);
+    int bestF = -1;
+    int bestTravel = INT_MAX;
+    for (int f = 0; f < F; ++f) {
+        if (m_flights[f].dest != dest || labLast[f] == NoLabel)
+            continue;
+        const int travel = m_flights[f].arrMin - labLast[f];
+        if (travel < bestTravel) {
+            bestTravel = travel;
+            bestF = f;
+        }
+    }
+    if (bestF < 0)
+        return false;
+
+    // menor nível que já atinge o rótulo: mesmo tempo com menos pernas
+    int level = 1;
+    while (label(level)[bestF] != labLast[bestF])
+        ++level;
+
+    for (int f = bestF; f >= 0 && level >= 1; --level) {
+        path.append(f);
+        f = prev(level)[f];
+    }
+    std::reverse(path.begin(), path.end());
+    return true;
+}
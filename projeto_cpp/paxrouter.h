@@ -0,0 +1,48 @@
+// paxrouter.h
+#ifndef PAXROUTER_H
+#define PAXROUTER_H
+
+#include <QVector>
+
+#include "gaengine.h"
+
+// Roteamento de passageiros numa rede expandida no tempo: cada voo ativo é
+// um nó e existe arco f -> g quando g parte do destino de f depois da
+// conexão mínima. Para um par OD, findPath devolve o itinerário de menor
+// tempo de viagem (chegada final - primeira partida) com até maxLegs pernas
+// e assento livre em todas elas. Cada busca custa O(maxLegs * (voos +
+// aeroportos)), independente do produto das listas de voos por par.
+//
+// Os voos devem estar ordenados por depMin; a capacidade livre é lida a
+// cada busca, então o chamador pode alocar assentos entre buscas
+// (aumentos sucessivos).
+class TimeExpandedRouter
+{
+public:
+    TimeExpandedRouter(const QVector<FlightInstance> &flights, int numAirports,
+                       int minConnMin, int maxLegs);
+
+    bool findPath(int orig, int dest, QVector<int> &path);
+
+private:
+    bool hasSeat(int f) const
+    {
+        return m_flights[f].capacity - m_flights[f].usedSeats > 0;
+    }
+    int *label(int level) { return m_label.data() + level * m_flights.size(); }
+    int *prev(int level) { return m_prev.data() + level * m_flights.size(); }
+
+    const QVector<FlightInstance> &m_flights;
+    int m_minConn;
+    int m_maxLegs;
+
+    QVector<int> m_byArrival; // índices de voos ordenados por chegada
+    // por nível k (1..maxLegs) e voo f: maior primeira partida de um
+    // itinerário de até k pernas terminando em f, e o voo anterior nele
+    QVector<int> m_label;
+    QVector<int> m_prev;
+    QVector<int> m_best;      // por aeroporto, durante a varredura
+    QVector<int> m_bestFrom;
+};
+
+#endif // PAXROUTER_H
@@ -0,0 +1,346 @@
+"""Bindings Python do engine do GA (AeroportosGA) via ctypes.
+
+Carrega a biblioteca compartilhada gerada por ``gacapi.pro`` e expõe o
+engine sem passar por arquivos JSON:
+
+    import aeroportos_ga as ga
+
+    eng = ga.Engine()
+    eng.load_data("airnet_inputs")                # ou os 5 caminhos
+    res = eng.run_ga(60, 60, progress=lambda g, s: print(g, s))
+    res.table("flights")["dep_min"]               # numpy.ndarray (int32)
+    res.to_pandas("assignments")                  # DataFrame, se houver pandas
+
+    genes = res.chromosome(eng.num_genes)         # numpy uint8 0/1
+    score, stats = eng.evaluate(genes)
+    scores, stats = eng.evaluate_many(pop)        # pop: (k, num_genes)
+
+As colunas de um ``Result`` apontam direto para a memória do resultado em
+C++ (sem cópia); o ``Result`` fica vivo enquanto algum array dele existir.
+
+A biblioteca é procurada em ``AEROPORTOS_GA_LIB`` (caminho completo) ou
+ao lado deste arquivo.
+"""
+
+import ctypes
+import os
+import struct
+import sys
+
+import numpy as np
+
+INT32 = 1
+FLOAT64 = 2
+
+STATS_FIELDS = (
+    "served_total", "served_direct", "served_1hop", "served_multihop",
+    "unserved", "num_flights", "used_aircraft", "total_travel_time_min",
+)
+
+_PROGRESS_FN = ctypes.CFUNCTYPE(None, ctypes.c_int, ctypes.c_double, ctypes.c_void_p)
+
+
+def _library_path():
+    env = os.environ.get("AEROPORTOS_GA_LIB")
+    if env:
+        return env
+    here = os.path.dirname(os.path.abspath(__file__))
+    if sys.platform.startswith("win"):
+        names = ["aeroportosga.dll"]
+    elif sys.platform == "darwin":
+        names = ["libaeroportosga.dylib"]
+    else:
+        names = ["libaeroportosga.so"]
+    for name in names:
+        path = os.path.join(here, name)
+        if os.path.exists(path):
+            return path
+    return names[0]  # deixa o loader do sistema procurar
+
+
+def _load_library():
+    lib = ctypes.CDLL(_library_path())
+    c_eng = ctypes.c_void_p
+    c_res = ctypes.c_void_p
+    c_u8p = ctypes.POINTER(ctypes.c_ubyte)
+    c_dp = ctypes.POINTER(ctypes.c_double)
+
+    def sig(name, restype, *argtypes):
+        fn = getattr(lib, name)
+        fn.restype = restype
+        fn.argtypes = list(argtypes)
+
+    sig("ga_engine_new", c_eng)
+    sig("ga_engine_free", None, c_eng)
+    sig("ga_last_error", ctypes.c_char_p, c_eng)
+    sig("ga_load_data", ctypes.c_int, c_eng, *([ctypes.c_char_p] * 5))
+    sig("ga_num_genes", ctypes.c_int, c_eng)
+    sig("ga_num_airports", ctypes.c_int, c_eng)
+    sig("ga_score_upper_bound", ctypes.c_double, c_eng)
+    sig("ga_set_params", None, c_eng, ctypes.c_double, ctypes.c_double,
+        ctypes.c_double, ctypes.c_int)
+    sig("ga_set_seed", None, c_eng, ctypes.c_uint)
+    sig("ga_set_repair", None, c_eng, ctypes.c_int)
+    sig("ga_set_adaptive_mutation", None, c_eng, ctypes.c_int)
+    sig("ga_set_gap_stop", None, c_eng, ctypes.c_double)
+    sig("ga_run", c_res, c_eng, ctypes.c_int, ctypes.c_int, _PROGRESS_FN, ctypes.c_void_p)
+    sig("ga_evaluate", ctypes.c_double, c_eng, c_u8p, ctypes.c_int, c_dp)
+    sig("ga_evaluate_many", ctypes.c_int, c_eng, c_u8p, ctypes.c_int, ctypes.c_int, c_dp, c_dp)
+    sig("ga_evaluate_detail", c_res, c_eng, c_u8p, ctypes.c_int)
+    sig("ga_result_free", None, c_res)
+    sig("ga_result_score", ctypes.c_double, c_res)
+    sig("ga_result_summary", ctypes.c_char_p, c_res)
+    sig("ga_result_num_columns", ctypes.c_int, c_res)
+    sig("ga_result_column", ctypes.c_int, c_res, ctypes.c_char_p, ctypes.c_char_p,
+        ctypes.POINTER(ctypes.c_void_p), ctypes.POINTER(ctypes.c_int),
+        ctypes.POINTER(ctypes.c_longlong))
+    sig("ga_result_write_columnar", ctypes.c_int, c_res, ctypes.c_char_p)
+    sig("ga_result_column_info", ctypes.c_int, c_res, ctypes.c_int,
+        ctypes.POINTER(ctypes.c_char_p), ctypes.POINTER(ctypes.c_char_p),
+        ctypes.POINTER(ctypes.c_int), ctypes.POINTER(ctypes.c_longlong))
+    return lib
+
+
+_lib = None
+
+
+def _get_lib():
+    global _lib
+    if _lib is None:
+        _lib = _load_library()
+    return _lib
+
+
+class GAError(RuntimeError):
+    pass
+
+
+def _as_genes(genes, num_genes):
+    arr = np.ascontiguousarray(genes, dtype=np.uint8)
+    if arr.ndim == 0 or arr.shape[-1] != num_genes:
+        raise ValueError("chromosome has %d genes, scenario has %d" % (arr.shape[-1], num_genes))
+    return arr
+
+
+class _ResultHandle:
+    """Dono do ga_result em C++; os arrays numpy seguram uma referência."""
+
+    def __init__(self, lib, handle):
+        self.lib = lib
+        self.handle = handle
+
+    def __del__(self):
+        if self.handle:
+            self.lib.ga_result_free(self.handle)
+            self.handle = None
+
+
+class Result:
+    """Resultado de ``run_ga`` / ``evaluate_detail`` em colunas numpy."""
+
+    def __init__(self, handle):
+        lib = _get_lib()
+        self._owner = _ResultHandle(lib, handle)
+        self.score = lib.ga_result_score(handle)
+        self.summary = lib.ga_result_summary(handle).decode("utf-8")
+        self._tables = {}
+        table = ctypes.c_char_p()
+        name = ctypes.c_char_p()
+        ctype = ctypes.c_int()
+        length = ctypes.c_longlong()
+        data = ctypes.c_void_p()
+        for i in range(lib.ga_result_num_columns(handle)):
+            lib.ga_result_column_info(handle, i, ctypes.byref(table), ctypes.byref(name),
+                                      ctypes.byref(ctype), ctypes.byref(length))
+            lib.ga_result_column(handle, table.value, name.value, ctypes.byref(data),
+                                 None, None)
+            columns = self._tables.setdefault(table.value.decode(), {})
+            columns[name.value.decode()] = self._view(ctype.value, length.value, data.value)
+
+    def _view(self, ctype, length, address):
+        dtype = np.int32 if ctype == INT32 else np.float64
+        if length == 0 or not address:
+            return np.zeros(0, dtype=dtype)
+        elem = ctypes.c_int32 if ctype == INT32 else ctypes.c_double
+        buf = (elem * length).from_address(address)
+        buf._owner = self._owner  # o array segura buf, que segura o ga_result
+        arr = np.frombuffer(buf, dtype=dtype)
+        arr.flags.writeable = False
+        return arr
+
+    @property
+    def tables(self):
+        return list(self._tables)
+
+    def table(self, name):
+        """Colunas da tabela (flights, assignments, legs, history)."""
+        return dict(self._tables[name])
+
+    def to_pandas(self, name):
+        import pandas as pd
+        return pd.DataFrame(self._tables[name], copy=False)
+
+    def write_columnar(self, path):
+        """Grava as colunas num arquivo .gacol (ver read_columnar)."""
+        if self._owner.lib.ga_result_write_columnar(self._owner.handle,
+                                                    os.fspath(path).encode("utf-8")) != 0:
+            raise GAError("cannot write %s" % path)
+
+    def chromosome(self, num_genes):
+        """Cromossomo denso (uint8 0/1) com os voos da solução."""
+        genes = np.zeros(num_genes, dtype=np.uint8)
+        genes[self._tables["flights"]["tmpl_id"]] = 1
+        return genes
+
+
+class Engine:
+    """Engine do GA (um cenário carregado por vez)."""
+
+    def __init__(self):
+        self._lib = _get_lib()
+        self._handle = self._lib.ga_engine_new()
+
+    def __del__(self):
+        if getattr(self, "_handle", None):
+            self._lib.ga_engine_free(self._handle)
+            self._handle = None
+
+    def _error(self):
+        return GAError(self._lib.ga_last_error(self._handle).decode("utf-8"))
+
+    def load_data(self, airports, routes=None, passengers=None, fleet=None, forbidden=None):
+        """Carrega os 5 JSONs de entrada; com um só argumento, é o diretório."""
+        if routes is None:
+            base = airports
+            airports = os.path.join(base, "airports.json")
+            routes = os.path.join(base, "routes.json")
+            passengers = os.path.join(base, "passengers.json")
+            fleet = os.path.join(base, "fleet.json")
+            forbidden = os.path.join(base, "forbidden_routes.json")
+        paths = [os.fspath(p).encode("utf-8") for p in
+                 (airports, routes, passengers, fleet, forbidden)]
+        if self._lib.ga_load_data(self._handle, *paths) != 0:
+            raise self._error()
+
+    @property
+    def num_genes(self):
+        return self._lib.ga_num_genes(self._handle)
+
+    @property
+    def num_airports(self):
+        return self._lib.ga_num_airports(self._handle)
+
+    @property
+    def score_upper_bound(self):
+        return self._lib.ga_score_upper_bound(self._handle)
+
+    def set_params(self, p_cross=0.8, p_mut=0.01, elite_frac=0.1, tournament_size=2):
+        self._lib.ga_set_params(self._handle, p_cross, p_mut, elite_frac, tournament_size)
+
+    def set_seed(self, seed):
+        self._lib.ga_set_seed(self._handle, seed)
+
+    def set_repair(self, on):
+        self._lib.ga_set_repair(self._handle, 1 if on else 0)
+
+    def set_gap_stop(self, gap):
+        self._lib.ga_set_gap_stop(self._handle, gap)
+
+    def set_adaptive_mutation(self, on):
+        self._lib.ga_set_adaptive_mutation(self._handle, 1 if on else 0)
+
+    def run_ga(self, population, generations, progress=None):
+        """Roda o GA; progress(gen, best_score) é chamado a cada geração."""
+        errors = []
+
+        def trampoline(gen, best, _user):
+            if errors:
+                return
+            try:
+                progress(gen, best)
+            except BaseException as exc:  # não deixa exceção atravessar o C++
+                errors.append(exc)
+
+        cb = _PROGRESS_FN(trampoline) if progress else _PROGRESS_FN()
+        handle = self._lib.ga_run(self._handle, population, generations, cb, None)
+        if not handle:
+            raise self._error()
+        result = Result(handle)
+        if errors:
+            raise errors[0]
+        return result
+
+    def evaluate(self, genes):
+        """(score, dict de EvalStats) de um cromossomo denso 0/1."""
+        arr = _as_genes(genes, self.num_genes)
+        stats = np.zeros(len(STATS_FIELDS), dtype=np.float64)
+        score = self._lib.ga_evaluate(self._handle,
+                                      arr.ctypes.data_as(ctypes.POINTER(ctypes.c_ubyte)),
+                                      arr.shape[-1],
+                                      stats.ctypes.data_as(ctypes.POINTER(ctypes.c_double)))
+        if self._lib.ga_last_error(self._handle):
+            raise self._error()
+        return score, dict(zip(STATS_FIELDS, stats.tolist()))
+
+    def evaluate_many(self, population):
+        """Avalia uma matriz (k, num_genes); devolve scores (k,) e stats (k, 8)."""
+        arr = _as_genes(population, self.num_genes)
+        if arr.ndim != 2:
+            raise ValueError("population must be a 2-D array")
+        k = arr.shape[0]
+        scores = np.empty(k, dtype=np.float64)
+        stats = np.empty((k, len(STATS_FIELDS)), dtype=np.float64)
+        rc = self._lib.ga_evaluate_many(self._handle,
+                                        arr.ctypes.data_as(ctypes.POINTER(ctypes.c_ubyte)),
+                                        k, arr.shape[1],
+                                        scores.ctypes.data_as(ctypes.POINTER(ctypes.c_double)),
+                                        stats.ctypes.data_as(ctypes.POINTER(ctypes.c_double)))
+        if rc != 0:
+            raise self._error()
+        return scores, stats
+
+    def evaluate_detail(self, genes):
+        """Avalia e devolve a solução completa como ``Result``."""
+        arr = _as_genes(genes, self.num_genes)
+        handle = self._lib.ga_evaluate_detail(self._handle,
+                                              arr.ctypes.data_as(ctypes.POINTER(ctypes.c_ubyte)),
+                                              arr.shape[-1])
+        if not handle:
+            raise self._error()
+        return Result(handle)
+
+
+def read_columnar(path, mmap=True):
+    """Lê um .gacol (ga_results.gacol) como {tabela: {coluna: ndarray}}.
+
+    Com mmap=True as colunas são np.memmap somente leitura: nada é lido
+    do disco até a coluna ser usada. Não precisa da biblioteca do engine.
+    """
+    with open(path, "rb") as f:
+        head = f.read(16)
+        if len(head) < 16 or head[:8] != b"GACOL\0\0\0":
+            raise GAError("%s: not a .gacol file" % path)
+        version, ncols = struct.unpack("<II", head[8:16])
+        if version != 1:
+            raise GAError("%s: unsupported .gacol version %d" % (path, version))
+        directory = []
+        for _ in range(ncols):
+            table = f.read(struct.unpack("<H", f.read(2))[0]).decode("utf-8")
+            name = f.read(struct.unpack("<H", f.read(2))[0]).decode("utf-8")
+            ctype, length, offset = struct.unpack("<BQQ", f.read(17))
+            directory.append((table, name, ctype, length, offset))
+        if not mmap:
+            f.seek(0)
+            data = f.read()
+
+    tables = {}
+    for table, name, ctype, length, offset in directory:
+        dtype = np.dtype("<i4") if ctype == INT32 else np.dtype("<f8")
+        if length == 0:
+            arr = np.zeros(0, dtype=dtype)
+        elif mmap:
+            arr = np.memmap(path, dtype=dtype, mode="r", offset=offset, shape=(length,))
+        else:
+            arr = np.frombuffer(data, dtype=dtype, count=length, offset=offset)
+        tables.setdefault(table, {})[name] = arr
+    return tables
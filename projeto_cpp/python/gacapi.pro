@@ -0,0 +1,39 @@
+# Biblioteca compartilhada com a API C do engine (gacapi.h), usada pelos
+# bindings Python em aeroportos_ga.py. Sem GUI: só QtCore e QtNetwork.
+#
+#   cd projeto_cpp/python && qmake && make
+#   -> libaeroportosga.so / aeroportosga.dll ao lado de aeroportos_ga.py
+
+QT       = core network
+
+TEMPLATE = lib
+TARGET   = aeroportosga
+CONFIG  += c++17 shared
+CONFIG  -= app_bundle
+DESTDIR  = $$PWD
+
+DEFINES += GACAPI_LIBRARY
+INCLUDEPATH += ..
+
+# a API exportada é só a de gacapi.h
+!win32: QMAKE_CXXFLAGS += -fvisibility=hidden
+
+SOURCES += \
+    ../gacapi.cpp \
+    ../gacolumns.cpp \
+    ../gaengine.cpp \
+    ../gajsonstream.cpp \
+    ../gametrics.cpp \
+    ../gatrace.cpp \
+    ../paxrouter.cpp
+
+HEADERS += \
+    ../gacapi.h \
+    ../gacolumns.h \
+    ../gaengine.h \
+    ../gajsonstream.h \
+    ../gametrics.h \
+    ../gatrace.h \
+    ../paxrouter.h
+
+win32: LIBS += -lpsapi